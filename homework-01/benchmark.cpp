@@ -0,0 +1,154 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "container_format.h"
+#include "random_fill.h"
+
+using namespace std;
+
+// Fills the vector once and prints the throughput in GB/s of generated data.
+template <typename T, typename Fill>
+void runCase(const string& label, vector<T>& values, Fill fill)
+{
+	auto start = chrono::steady_clock::now();
+	fill(values);
+	auto end = chrono::steady_clock::now();
+
+	double seconds = chrono::duration<double>(end - start).count();
+	double bytes = static_cast<double>(values.size() * sizeof(T));
+	cout << left << setw(40) << label << right << fixed << setprecision(2)
+		<< setw(8) << bytes / seconds / 1e9 << " GB/s" << setw(10) << setprecision(1) << seconds * 1e3 << " ms"
+		<< "   first: " << values.front() << endl;
+}
+
+void benchmarkRandomFill(size_t size)
+{
+	unsigned threads = max(1u, thread::hardware_concurrency());
+	cout << "------ Random fill: " << size << " elements, " << threads << " hardware threads ------\n" << endl;
+
+	vector<int> ints(size);
+	runCase("rand() % 1000", ints, [](vector<int>& v) {
+		for (auto& element : v)
+			element = rand() % 1000;
+	});
+	runCase("mt19937 + uniform_int_distribution", ints, [](vector<int>& v) {
+		mt19937 engine(42);
+		uniform_int_distribution<int> distribution(0, 999);
+		for (auto& element : v)
+			element = distribution(engine);
+	});
+	runCase("SplitMix64, 1 thread", ints, [](vector<int>& v) {
+		randomFill<SplitMix64>(v, UniformInt<int>(0, 999), 42, 1);
+	});
+	runCase("Philox4x32, 1 thread", ints, [](vector<int>& v) {
+		randomFill<Philox4x32>(v, UniformInt<int>(0, 999), 42, 1);
+	});
+	runCase("SplitMix64, all threads", ints, [](vector<int>& v) {
+		randomFill<SplitMix64>(v, UniformInt<int>(0, 999), 42);
+	});
+	runCase("Philox4x32, all threads", ints, [](vector<int>& v) {
+		randomFill<Philox4x32>(v, UniformInt<int>(0, 999), 42);
+	});
+
+	vector<double> doubles(size);
+	cout << endl;
+	runCase("mt19937_64 + normal_distribution", doubles, [](vector<double>& v) {
+		mt19937_64 engine(42);
+		normal_distribution<double> distribution(0.0, 1.0);
+		for (auto& element : v)
+			element = distribution(engine);
+	});
+	runCase("SplitMix64 uniform [0, 1), all threads", doubles, [](vector<double>& v) {
+		randomFill(v, UniformReal<double>(), 42);
+	});
+	runCase("SplitMix64 normal, all threads", doubles, [](vector<double>& v) {
+		randomFill(v, Normal<double>(), 42);
+	});
+
+	// The same seed must give the same data whatever the number of threads.
+	vector<int> sequential = randomVector(size, UniformInt<int>(0, 999), 7, 1);
+	vector<int> parallel = randomVector(size, UniformInt<int>(0, 999), 7, 8);
+	cout << "\nSame result with 1 and 8 threads: " << (sequential == parallel ? "yes" : "NO") << endl;
+}
+
+// Writes the container to the file once and prints the throughput in MB/s of text written.
+template <typename Write>
+void runFormatCase(const string& label, const char* path, Write write)
+{
+	ofstream file(path, ios::binary);
+	auto start = chrono::steady_clock::now();
+	write(file);
+	file.flush();
+	auto end = chrono::steady_clock::now();
+
+	double seconds = chrono::duration<double>(end - start).count();
+	double bytes = static_cast<double>(file.tellp());
+	cout << left << setw(40) << label << right << fixed << setprecision(1)
+		<< setw(8) << bytes / seconds / 1e6 << " MB/s" << setw(10) << seconds * 1e3 << " ms" << endl;
+}
+
+// Element-by-element iostream output, as rangeLoop and printVec used to do, against ContainerFormatter.
+void benchmarkFormatting(size_t size)
+{
+	cout << "\n------ Formatting: " << size << " elements ------\n" << endl;
+	const char* path = "format_benchmark.txt";
+
+	vector<int> ints = randomVector(size, UniformInt<int>(-1000000, 1000000), 1);
+	runFormatCase("int, iostream per element", path, [&](ostream& out) {
+		for (size_t i = 0; i < ints.size(); ++i) {
+			out << ints[i];
+			if (i + 1 < ints.size()) { out << ", "; }
+		}
+	});
+	runFormatCase("int, printContainer", path, [&](ostream& out) {
+		printContainer(out, ints);
+	});
+	runFormatCase("int, formatContainer (to string)", path, [&](ostream& out) {
+		string text = formatContainer(ints);
+		out.write(text.data(), static_cast<streamsize>(text.size()));
+	});
+
+	list<int> intList(ints.begin(), ints.end());
+	runFormatCase("list<int>, printContainer", path, [&](ostream& out) {
+		printContainer(out, intList);
+	});
+
+	vector<double> doubles = randomVector(size, UniformReal<double>(-1000.0, 1000.0), 1);
+	runFormatCase("double, iostream per element", path, [&](ostream& out) {
+		for (size_t i = 0; i < doubles.size(); ++i) {
+			out << doubles[i];
+			if (i + 1 < doubles.size()) { out << ", "; }
+		}
+	});
+	runFormatCase("double, printContainer (6 digits)", path, [&](ostream& out) {
+		printContainer(out, doubles, { .precision = 6 });
+	});
+	runFormatCase("double, printContainer (shortest)", path, [&](ostream& out) {
+		printContainer(out, doubles);
+	});
+
+	runFormatCase("int, first/last 10 only", path, [&](ostream& out) {
+		printContainer(out, ints, { .head = 10, .tail = 10 });
+	});
+
+	remove(path);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t fillSize = argc > 1 ? stoull(argv[1]) : 32 * 1024 * 1024;
+	size_t formatSize = argc > 2 ? stoull(argv[2]) : 10 * 1000 * 1000;
+
+	benchmarkRandomFill(fillSize);
+	benchmarkFormatting(formatSize);
+
+	return 0;
+}
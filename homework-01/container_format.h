@@ -0,0 +1,181 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+// How ContainerFormatter lays out a container.
+struct FormatOptions {
+	std::string_view separator = ", ";
+	std::string_view open = "";  // Written before the first element, e.g. "[".
+	std::string_view close = ""; // Written after the last element, e.g. "]".
+	// Truncation: containers with more than head + tail elements are written as the first `head` elements,
+	// "..." and the last `tail` elements.
+	size_t head = std::numeric_limits<size_t>::max();
+	size_t tail = 0;
+	// Significant digits for floating point elements; -1 for the shortest text that reads back the same value.
+	int precision = -1;
+};
+
+// Writes containers as text much faster than streaming each element through std::cout: numbers are converted
+// with std::to_chars straight into a buffer, and the buffer goes to the stream in large chunks.
+// Works with any range (std::vector, std::list, std::map keys, arrays, ...) and any element type:
+// numbers, characters and strings are handled directly, everything else through its operator<<.
+// The buffer is kept between calls, so reusing one formatter does not allocate.
+class ContainerFormatter
+{
+private:
+	static constexpr size_t CHUNK = 64 * 1024;
+	static constexpr size_t MAX_NUMBER_LENGTH = 512; // Room reserved before converting one number.
+
+	std::vector<char> buffer = std::vector<char>(CHUNK);
+	size_t used = 0;
+	std::ostringstream fallback; // For element types without a faster path.
+
+	template <typename Sink>
+	void flush(Sink& sink) {
+		if (used > 0) {
+			sink(buffer.data(), used);
+			used = 0;
+		}
+	}
+
+	template <typename Sink>
+	void append(Sink& sink, std::string_view text) {
+		if (buffer.size() - used < text.size()) {
+			flush(sink);
+			if (text.size() > buffer.size()) {
+				sink(text.data(), text.size()); // Too long to buffer; written directly.
+				return;
+			}
+		}
+		text.copy(buffer.data() + used, text.size());
+		used += text.size();
+	}
+
+	template <typename Sink, typename T>
+	void appendElement(Sink& sink, const T& value, int precision) {
+		if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+			append(sink, std::string_view(reinterpret_cast<const char*>(&value), 1));
+		}
+		else if constexpr (std::is_same_v<T, bool>) {
+			append(sink, value ? "1" : "0");
+		}
+		else if constexpr (std::is_arithmetic_v<T>) {
+			if (buffer.size() - used < MAX_NUMBER_LENGTH) { flush(sink); }
+			char* first = buffer.data() + used;
+			char* last = buffer.data() + buffer.size();
+			std::to_chars_result result;
+			if constexpr (std::is_floating_point_v<T>) {
+				result = precision < 0 ? std::to_chars(first, last, value) : std::to_chars(first, last, value, std::chars_format::general, precision);
+			}
+			else {
+				result = std::to_chars(first, last, value);
+			}
+			if (result.ec == std::errc()) {
+				used = static_cast<size_t>(result.ptr - buffer.data());
+			}
+			else {
+				// Only a very large precision needs more room than MAX_NUMBER_LENGTH.
+				fallback.str("");
+				fallback.precision(precision);
+				fallback << value;
+				append(sink, fallback.view());
+			}
+		}
+		else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+			append(sink, std::string_view(value));
+		}
+		else {
+			fallback.str("");
+			fallback.precision(6);
+			fallback << value;
+			append(sink, fallback.view());
+		}
+	}
+
+	template <typename Sink, typename Iterator>
+	Iterator appendElements(Sink& sink, Iterator it, size_t count, const FormatOptions& options, bool& first) {
+		for (size_t i = 0; i < count; ++i, ++it) {
+			if (!first) { append(sink, options.separator); }
+			first = false;
+			appendElement(sink, *it, options.precision);
+		}
+		return it;
+	}
+
+	template <typename Sink, typename Iterator, typename Sentinel>
+	void write(Sink& sink, Iterator it, Sentinel last, const FormatOptions& options) {
+		append(sink, options.open);
+		bool first = true;
+		if constexpr (std::forward_iterator<Iterator>) {
+			size_t size = static_cast<size_t>(std::ranges::distance(it, last));
+			if (options.head < size && size - options.head > options.tail) {
+				it = appendElements(sink, it, options.head, options, first);
+				if (!first) { append(sink, options.separator); }
+				append(sink, "...");
+				first = false;
+				it = std::ranges::next(it, static_cast<std::iter_difference_t<Iterator>>(size - options.head - options.tail));
+				appendElements(sink, it, options.tail, options, first);
+				append(sink, options.close);
+				return;
+			}
+		}
+		for (; it != last; ++it) {
+			if (!first) { append(sink, options.separator); }
+			first = false;
+			appendElement(sink, *it, options.precision);
+		}
+		append(sink, options.close);
+	}
+
+public:
+	ContainerFormatter() = default;
+
+	ContainerFormatter(const ContainerFormatter&) = delete;
+	ContainerFormatter& operator=(const ContainerFormatter&) = delete;
+
+	// Writes the elements in [first, last) to out.
+	template <typename Iterator, typename Sentinel>
+	void print(std::ostream& out, Iterator first, Sentinel last, const FormatOptions& options = {}) {
+		auto sink = [&out](const char* text, size_t length) { out.write(text, static_cast<std::streamsize>(length)); };
+		write(sink, first, last, options);
+		flush(sink);
+	}
+
+	template <std::ranges::input_range Range>
+	void print(std::ostream& out, const Range& range, const FormatOptions& options = {}) {
+		print(out, std::ranges::begin(range), std::ranges::end(range), options);
+	}
+
+	template <std::ranges::input_range Range>
+	std::string format(const Range& range, const FormatOptions& options = {}) {
+		std::string text;
+		auto sink = [&text](const char* chunk, size_t length) { text.append(chunk, length); };
+		write(sink, std::ranges::begin(range), std::ranges::end(range), options);
+		flush(sink);
+		return text;
+	}
+};
+
+// Writes a container with a formatter kept per thread, so repeated calls reuse its buffer.
+template <std::ranges::input_range Range>
+void printContainer(std::ostream& out, const Range& range, const FormatOptions& options = {}) {
+	thread_local ContainerFormatter formatter;
+	formatter.print(out, range, options);
+}
+
+template <std::ranges::input_range Range>
+std::string formatContainer(const Range& range, const FormatOptions& options = {}) {
+	thread_local ContainerFormatter formatter;
+	return formatter.format(range, options);
+}
@@ -1,14 +1,19 @@
 #include <iostream>
+#include <random>
+#include <string>
+#include <typeinfo>
 #include <vector>
+#include "container_format.h"
+#include "random_fill.h"
 
 using namespace std;
 
+// Values in [0, 999]. The same seed always gives the same vector; large vectors are filled in parallel.
 template <typename F>
-void randFillVec(vector<F>& v, size_t size = 5)
+void randFillVec(vector<F>& v, size_t size = 5, uint64_t seed = random_device{}())
 {
 	v.resize(size);
-	for (auto& element : v)
-		element = rand() % 1000;
+	randomFill(v, uniformDistribution<F>(0, 999), seed);
 }
 
 template <typename R>
@@ -16,12 +21,7 @@ void rangeLoop(const vector<R>& v)
 {
 	cout << "Vector type: " << typeid(R).name() << endl
 	     << "Range based loop: ";
-	size_t count = 0;
-	for (const auto& element : v)
-	{
-		cout << element;
-		if (++count < v.size()) { cout << ", "; }
-	}
+	printContainer(cout, v);
 	cout << endl;
 }
 
@@ -30,15 +30,12 @@ void iteratorLoop(const vector<I>& v)
 {
 	cout << "Vector type: " << typeid(I).name() << endl
 		 << "Iterator based loop: ";
-	for (auto it = v.begin(); it != v.end(); ++it)
-		cout << *it << (it != (v.end() - 1) ? ", ": "");
+	printContainer(cout, ranges::subrange(v.begin(), v.end()));
 	cout << endl;
 }
 
-void main()
+int main()
 {
-	srand(static_cast<unsigned int>(time(NULL)));
-
 	vector<string> vString({ "parents", "siblings", "children", "grandparents", "relatives" });
 	vector<int> vNum;
 	randFillVec(vNum);
@@ -47,4 +44,6 @@ void main()
 	rangeLoop(vString);
 	cout << endl;
 	iteratorLoop(vNum);
+
+	return 0;
 }
\ No newline at end of file
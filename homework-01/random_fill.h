@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fast, reproducible random data for test datasets.
+//
+// The engines are counter-based: the n-th 64-bit word of a sequence is a pure function of (seed, n), so any
+// part of a container can be filled without generating what comes before it. Element i always takes the
+// words [i * WORDS, (i + 1) * WORDS) of its distribution, which makes the result depend only on the seed,
+// never on how many threads filled it.
+
+// High half of the 128-bit product of two 64-bit numbers.
+inline uint64_t multiplyHigh(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 Wide;
+	return static_cast<uint64_t>((static_cast<Wide>(a) * b) >> 64);
+#else
+	uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+	uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+	uint64_t low = aLow * bLow;
+	uint64_t middle1 = aHigh * bLow + (low >> 32);
+	uint64_t middle2 = aLow * bHigh + (middle1 & 0xFFFFFFFF);
+	return aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+#endif
+}
+
+// SplitMix64 (Steele, Lea, Flood): word n is the finalizer applied to seed + (n + 1) * golden ratio.
+// About one nanosecond per word; the default engine.
+class SplitMix64
+{
+private:
+	static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ull;
+	uint64_t base;
+
+	static uint64_t mix(uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+public:
+	// The seed is mixed first, so neighbouring seeds do not give shifted copies of one sequence.
+	explicit SplitMix64(uint64_t seed) : base(mix(seed)) {}
+
+	uint64_t operator()(uint64_t counter) const {
+		return mix(base + (counter + 1) * GAMMA);
+	}
+
+	// Words [counter, counter + count) into out.
+	void generate(uint64_t counter, uint64_t* out, size_t count) const {
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = (*this)(counter + i);
+		}
+	}
+};
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"): ten rounds of multiply
+// and xor over a 128-bit counter, keyed by the seed. Passes BigCrush; each block gives two 64-bit words.
+class Philox4x32
+{
+private:
+	uint32_t key0;
+	uint32_t key1;
+
+	struct Block {
+		uint32_t x[4];
+	};
+
+	Block encrypt(uint64_t block) const {
+		uint32_t c0 = static_cast<uint32_t>(block), c1 = static_cast<uint32_t>(block >> 32), c2 = 0, c3 = 0;
+		uint32_t k0 = key0, k1 = key1;
+		for (int round = 0; round < 10; ++round) {
+			uint64_t product0 = uint64_t{ 0xD2511F53 } * c0;
+			uint64_t product1 = uint64_t{ 0xCD9E8D57 } * c2;
+			uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+			uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+			c1 = static_cast<uint32_t>(product1);
+			c3 = static_cast<uint32_t>(product0);
+			c0 = next0;
+			c2 = next2;
+			k0 += 0x9E3779B9;
+			k1 += 0xBB67AE85;
+		}
+		return { { c0, c1, c2, c3 } };
+	}
+
+	static uint64_t word(const Block& block, uint64_t half) {
+		return half == 0 ? (uint64_t{ block.x[1] } << 32 | block.x[0]) : (uint64_t{ block.x[3] } << 32 | block.x[2]);
+	}
+
+public:
+	explicit Philox4x32(uint64_t seed) : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)) {}
+
+	uint64_t operator()(uint64_t counter) const {
+		return word(encrypt(counter / 2), counter % 2);
+	}
+
+	// Words [counter, counter + count) into out; every block is encrypted once.
+	void generate(uint64_t counter, uint64_t* out, size_t count) const {
+		size_t i = 0;
+		if (count > 0 && counter % 2 == 1) {
+			out[i++] = (*this)(counter);
+		}
+		for (; i + 1 < count; i += 2) {
+			Block block = encrypt((counter + i) / 2);
+			out[i] = word(block, 0);
+			out[i + 1] = word(block, 1);
+		}
+		if (i < count) {
+			out[i] = (*this)(counter + i);
+		}
+	}
+};
+
+// --- Distributions ---
+// A distribution turns WORDS random words into one element. Using a fixed number of words per element
+// (no rejection loops) is what keeps parallel fills deterministic.
+
+// Integers in [low, high], by Lemire's multiply-shift: the bias is at most (high - low + 1) / 2^64, far below
+// anything measurable, where rand() % n favours the small values.
+template <typename T>
+struct UniformInt {
+	static_assert(std::is_integral_v<T> && sizeof(T) <= 8, "UniformInt needs an integer type of up to 64 bits.");
+	static constexpr size_t WORDS = 1;
+	T low;
+	T high;
+
+	UniformInt(T minimum = std::numeric_limits<T>::min(), T maximum = std::numeric_limits<T>::max()) : low(minimum), high(maximum) {}
+
+	T operator()(const uint64_t* words) const {
+		uint64_t range = static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1; // 0 for the full 64-bit range.
+		uint64_t offset = range == 0 ? words[0] : multiplyHigh(words[0], range);
+		return static_cast<T>(static_cast<uint64_t>(low) + offset);
+	}
+};
+
+// Floating point numbers in [low, high), from the top 53 (or 24) bits of a word.
+template <typename T>
+struct UniformReal {
+	static_assert(std::is_floating_point_v<T>, "UniformReal needs a floating point type.");
+	static constexpr size_t WORDS = 1;
+	T low;
+	T high;
+
+	UniformReal(T minimum = 0, T maximum = 1) : low(minimum), high(maximum) {}
+
+	T operator()(const uint64_t* words) const {
+		if constexpr (std::is_same_v<T, float>) {
+			return low + (high - low) * (static_cast<float>(words[0] >> 40) * 0x1.0p-24f);
+		}
+		else {
+			return low + (high - low) * static_cast<T>(static_cast<double>(words[0] >> 11) * 0x1.0p-53);
+		}
+	}
+};
+
+// Normally distributed numbers, by the Box-Muller transform.
+template <typename T>
+struct Normal {
+	static_assert(std::is_floating_point_v<T>, "Normal needs a floating point type.");
+	static constexpr size_t WORDS = 2;
+	T mean;
+	T stddev;
+
+	Normal(T average = 0, T deviation = 1) : mean(average), stddev(deviation) {}
+
+	T operator()(const uint64_t* words) const {
+		double u1 = (static_cast<double>(words[0] >> 11) + 1.0) * 0x1.0p-53; // (0, 1], so the logarithm is finite.
+		double u2 = static_cast<double>(words[1] >> 11) * 0x1.0p-53;
+		return mean + stddev * static_cast<T>(std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2));
+	}
+};
+
+// true with probability p.
+struct Bernoulli {
+	static constexpr size_t WORDS = 1;
+	double p;
+
+	explicit Bernoulli(double probability = 0.5) : p(probability) {}
+
+	bool operator()(const uint64_t* words) const {
+		return static_cast<double>(words[0] >> 11) * 0x1.0p-53 < p;
+	}
+};
+
+// Any element type: make(words) builds an element from Words random words, e.g. a struct or a string.
+template <size_t Words, typename F>
+struct CustomDistribution {
+	static constexpr size_t WORDS = Words;
+	F make;
+
+	auto operator()(const uint64_t* words) const {
+		return make(words);
+	}
+};
+
+template <size_t Words = 1, typename F>
+CustomDistribution<Words, F> customDistribution(F make) {
+	return { make };
+}
+
+// UniformInt or UniformReal, whichever fits T.
+template <typename T>
+auto uniformDistribution(T low, T high) {
+	if constexpr (std::is_floating_point_v<T>) {
+		return UniformReal<T>(low, high);
+	}
+	else {
+		return UniformInt<T>(low, high);
+	}
+}
+
+// --- Filling ---
+
+// Elements generated per batch: their words are produced together into a buffer on the stack.
+constexpr size_t RANDOM_FILL_BATCH = 256;
+// Containers smaller than this are filled on the calling thread.
+constexpr size_t RANDOM_FILL_PARALLEL_THRESHOLD = size_t(1) << 16;
+
+// Assigns elements [first, first + count) of the sequence to out, out + 1, ...
+template <typename Engine, typename Distribution, typename Iterator>
+void randomFillSequence(const Engine& engine, const Distribution& distribution, size_t first, size_t count, Iterator out) {
+	constexpr size_t WORDS = Distribution::WORDS;
+	uint64_t words[RANDOM_FILL_BATCH * WORDS];
+	for (size_t done = 0; done < count;) {
+		size_t batch = std::min(RANDOM_FILL_BATCH, count - done);
+		engine.generate((first + done) * WORDS, words, batch * WORDS);
+		for (size_t i = 0; i < batch; ++i, ++out) {
+			*out = distribution(words + i * WORDS);
+		}
+		done += batch;
+	}
+}
+
+// Fills every element of the range from the seed. Random access ranges of at least RANDOM_FILL_PARALLEL_THRESHOLD
+// elements are split into chunks filled by `threads` threads (0: one per hardware thread); the result is the
+// same for any thread count. Chunks start at multiples of RANDOM_FILL_BATCH elements, so even std::vector<bool>'s
+// packed words are never shared between threads.
+template <typename Engine = SplitMix64, typename Range, typename Distribution>
+void randomFill(Range&& range, const Distribution& distribution, uint64_t seed, size_t threads = 0) {
+	Engine engine(seed);
+	if constexpr (std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>) {
+		size_t size = static_cast<size_t>(std::ranges::size(range));
+		if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+		if (size < RANDOM_FILL_PARALLEL_THRESHOLD || threads <= 1) {
+			randomFillSequence(engine, distribution, 0, size, std::ranges::begin(range));
+			return;
+		}
+
+		size_t chunk = ((size + threads - 1) / threads + RANDOM_FILL_BATCH - 1) / RANDOM_FILL_BATCH * RANDOM_FILL_BATCH;
+		auto begin = std::ranges::begin(range);
+		std::vector<std::thread> workers;
+		for (size_t first = chunk; first < size; first += chunk) {
+			size_t count = std::min(chunk, size - first);
+			workers.emplace_back([&engine, &distribution, begin, first, count] {
+				randomFillSequence(engine, distribution, first, count, begin + static_cast<std::ptrdiff_t>(first));
+			});
+		}
+		randomFillSequence(engine, distribution, 0, std::min(chunk, size), begin);
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+	else {
+		// Lists and other sequential ranges get the same values, generated on the calling thread.
+		randomFillSequence(engine, distribution, 0, static_cast<size_t>(std::ranges::distance(range)), std::ranges::begin(range));
+	}
+}
+
+// A new vector of `size` random elements.
+template <typename Engine = SplitMix64, typename Distribution>
+auto randomVector(size_t size, const Distribution& distribution, uint64_t seed, size_t threads = 0) {
+	using T = std::decay_t<decltype(distribution(std::declval<const uint64_t*>()))>;
+	std::vector<T> values(size);
+	randomFill<Engine>(values, distribution, seed, threads);
+	return values;
+}
@@ -0,0 +1,413 @@
+// BigData logs like LegacyBigData does, so the two are compared on equal terms; benchmarkTracing
+// instantiates the other tracing policies explicitly.
+#define BIGDATA_LOGGING
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+#include "big_data.h"
+#include "shared_big_data.h"
+
+// Forwards to new_delete_resource() and counts the allocations. The benchmarks pass it to every BigData and
+// SharedBigData they create, and as the upstream of the pool resource, so only payload allocations are counted.
+// Atomic because the sharing benchmark copies from several threads.
+class CountingResource : public std::pmr::memory_resource {
+private:
+	std::atomic<size_t> allocations{ 0 };
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+		std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	size_t count() const {
+		return allocations;
+	}
+};
+
+static CountingResource countingResource;
+
+// LegacyBigData allocates with new[] and cannot take a memory resource, so it counts its own allocations.
+static size_t legacyAllocationCount = 0;
+
+// The BigData implementation before the small-buffer optimization, kept as a baseline.
+class LegacyBigData {
+private:
+	int* data;
+	size_t size;
+
+public:
+	LegacyBigData(const size_t s) : size(s) {
+		std::cout << "Constructor has been called." << std::endl;
+
+		data = new int[size]{};
+		++legacyAllocationCount;
+	}
+
+	~LegacyBigData() {
+		std::cout << "Destructor has been called." << std::endl;
+
+		delete[] data;
+	}
+
+	LegacyBigData(const LegacyBigData& other) : size(other.size) {
+		std::cout << "Copy constructor has been called." << std::endl;
+
+		data = new int[other.size];
+		++legacyAllocationCount;
+		for (size_t i = 0; i < other.size; i++) {
+			data[i] = other.data[i];
+		}
+	}
+
+	LegacyBigData& operator=(const LegacyBigData& other) {
+		std::cout << "Copy assignment operator has been called." << std::endl;
+
+		if (this != &other) {
+			delete[] data;
+
+			size = other.size;
+			data = new int[size];
+			++legacyAllocationCount;
+			for (size_t i = 0; i < other.size; i++) {
+				data[i] = other.data[i];
+			}
+		}
+		return *this;
+	}
+};
+
+// Runs the workload and prints its time and payload allocations per operation.
+template <typename Workload>
+void runCase(const std::string& label, size_t operations, Workload workload) {
+	size_t allocationsBefore = countingResource.count() + legacyAllocationCount;
+	auto start = std::chrono::steady_clock::now();
+	workload();
+	auto end = std::chrono::steady_clock::now();
+	size_t allocations = countingResource.count() + legacyAllocationCount - allocationsBefore;
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	std::cerr << std::left << std::setw(36) << label << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(10) << ns / operations << " ns/op" << std::setprecision(3)
+		<< std::setw(10) << static_cast<double>(allocations) / operations << " allocations/op" << std::endl;
+}
+
+// Construction, copy construction and copy assignment of payloads of one size.
+void benchmarkSize(size_t size, size_t operations) {
+	std::cerr << "\n------ " << size << " elements, " << operations << " operations each ------\n" << std::endl;
+
+	LegacyBigData legacySource(size);
+	BigData source(size, &countingResource);
+	std::pmr::unsynchronized_pool_resource pool(&countingResource);
+
+	runCase("Legacy: construct", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { LegacyBigData value(size); }
+	});
+	runCase("BigData: construct", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { BigData value(size, &countingResource); }
+	});
+	runCase("BigData (pool resource): construct", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { BigData value(size, &pool); }
+	});
+
+	runCase("Legacy: copy construct", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { LegacyBigData value(legacySource); }
+	});
+	runCase("BigData: copy construct", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { BigData value(source, &countingResource); }
+	});
+	runCase("BigData (pool resource): copy", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { BigData value(source, &pool); }
+	});
+
+	LegacyBigData legacyTarget(size);
+	BigData target(size, &countingResource);
+	runCase("Legacy: copy assign", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { legacyTarget = legacySource; }
+	});
+	runCase("BigData: copy assign (reuses)", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) { target = source; }
+	});
+}
+
+// Times one pass of an operation over the buffers and prints the throughput in GB/s of touched memory.
+template <typename Operation>
+void runBulkCase(const std::string& label, size_t bytes, Operation operation) {
+	auto start = std::chrono::steady_clock::now();
+	long long result = operation();
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	std::cerr << std::left << std::setw(36) << label << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << bytes / seconds / 1e9 << " GB/s" << std::setw(12) << std::setprecision(1) << seconds * 1e3 << " ms"
+		<< "   check: " << result << std::endl;
+}
+
+// Compares element-by-element loops through the bounds-checked operator[] with the bulk operations.
+void benchmarkBulkOperations(size_t size) {
+	std::cerr << "\n------ Bulk operations on " << size << " elements ------\n" << std::endl;
+
+	BigData first(size);
+	BigData second(size);
+	size_t bytes = size * sizeof(int);
+
+	runBulkCase("Loop: fill", bytes, [&] {
+		for (size_t i = 0; i < size; ++i) { first[i] = 3; }
+		return static_cast<long long>(first[size - 1]);
+	});
+	runBulkCase("BigData::fill", bytes, [&] {
+		first.fill(3);
+		return static_cast<long long>(first[size - 1]);
+	});
+
+	runBulkCase("Loop: copy", 2 * bytes, [&] {
+		for (size_t i = 0; i < size; ++i) { second[i] = first[i]; }
+		return static_cast<long long>(second[size - 1]);
+	});
+	runBulkCase("BigData::copyFrom", 2 * bytes, [&] {
+		second.copyFrom(first);
+		return static_cast<long long>(second[size - 1]);
+	});
+
+	runBulkCase("Loop: add scalar", 2 * bytes, [&] {
+		for (size_t i = 0; i < size; ++i) { first[i] += 1; }
+		return static_cast<long long>(first[size - 1]);
+	});
+	runBulkCase("BigData::addScalar", 2 * bytes, [&] {
+		first.addScalar(1);
+		return static_cast<long long>(first[size - 1]);
+	});
+
+	runBulkCase("Loop: add", 3 * bytes, [&] {
+		for (size_t i = 0; i < size; ++i) { first[i] += second[i]; }
+		return static_cast<long long>(first[size - 1]);
+	});
+	runBulkCase("BigData::add", 3 * bytes, [&] {
+		first.add(second);
+		return static_cast<long long>(first[size - 1]);
+	});
+
+	runBulkCase("Loop: multiply", 3 * bytes, [&] {
+		for (size_t i = 0; i < size; ++i) { first[i] *= second[i]; }
+		return static_cast<long long>(first[size - 1]);
+	});
+	runBulkCase("BigData::multiply", 3 * bytes, [&] {
+		first.multiply(second);
+		return static_cast<long long>(first[size - 1]);
+	});
+
+	runBulkCase("Loop: sum", bytes, [&] {
+		long long total = 0;
+		for (size_t i = 0; i < size; ++i) { total += first[i]; }
+		return total;
+	});
+	runBulkCase("BigData::sum", bytes, [&] { return first.sum(); });
+}
+
+// Threads copy, slice, read and write one shared buffer at the same time. Every reader must see the original
+// values, writes must stay private to the writing copy, and the reference count must return to one.
+bool stressSharedBigData(size_t threadCount, size_t iterations) {
+	const size_t size = 1 << 16;
+	SharedBigData source(size);
+	int* values = source.mutableData();
+	for (size_t i = 0; i < size; ++i) { values[i] = static_cast<int>(i); }
+
+	std::atomic<bool> failed{ false };
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&, t] {
+			std::vector<SharedBigData> kept; // Released in a different order than they were made.
+			for (size_t i = 0; i < iterations; ++i) {
+				size_t start = (i * 7919 + t * 104729) % size;
+				SharedBigData copy = source;
+				SharedBigData view = copy.slice(start, std::min<size_t>(64, size - start));
+				if (view[0] != static_cast<int>(start) || view[view.getSize() - 1] != static_cast<int>(start + view.getSize() - 1)) {
+					failed = true;
+				}
+				if (i % 8 == 0) {
+					view.set(0, -1);
+					if (view[0] != -1 || copy[start] != static_cast<int>(start)) { failed = true; }
+				}
+				kept.push_back(std::move(view));
+				if (kept.size() == 16) {
+					kept.erase(kept.begin() + static_cast<std::ptrdiff_t>(i % 16));
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	for (size_t i = 0; i < size; ++i) {
+		if (source[i] != static_cast<int>(i)) { failed = true; }
+	}
+	return !failed && source.useCount() == 1;
+}
+
+// Copy-heavy workloads: handing a buffer to many readers, writing to a copy and taking a subrange.
+void benchmarkSharedCopies(size_t size, size_t operations) {
+	std::cerr << "\n------ Copy-on-write, " << size << " elements, " << operations << " operations each ------\n" << std::endl;
+
+	BigData source(size, &countingResource);
+	SharedBigData sharedSource(source, &countingResource);
+	size_t quarter = size / 4;
+	long long checksum = 0;
+
+	runCase("BigData: copy and read", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			BigData copy(source, &countingResource);
+			checksum += copy[i % size];
+		}
+	});
+	runCase("SharedBigData: copy and read", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			SharedBigData copy(sharedSource);
+			checksum += copy[i % size];
+		}
+	});
+
+	runCase("BigData: copy and write", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			BigData copy(source, &countingResource);
+			copy[i % size] = 1;
+			checksum += copy[i % size];
+		}
+	});
+	runCase("SharedBigData: copy and write", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			SharedBigData copy(sharedSource);
+			copy.set(i % size, 1);
+			checksum += copy[i % size];
+		}
+	});
+
+	runCase("BigData: copy a quarter", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			BigData part(quarter, &countingResource);
+			std::copy(source.begin() + quarter, source.begin() + 2 * quarter, part.begin());
+			checksum += part.getSize();
+		}
+	});
+	runCase("SharedBigData: slice a quarter", operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			SharedBigData part = sharedSource.slice(quarter, quarter);
+			checksum += part.getSize();
+		}
+	});
+
+	std::vector<std::thread> readers;
+	size_t threadCount = std::max(2u, std::thread::hardware_concurrency());
+	runCase("SharedBigData: copies in " + std::to_string(threadCount) + " threads", operations * threadCount, [&] {
+		for (size_t t = 0; t < threadCount; ++t) {
+			readers.emplace_back([&] {
+				for (size_t i = 0; i < operations; ++i) {
+					SharedBigData copy(sharedSource);
+				}
+			});
+		}
+		for (auto& reader : readers) {
+			reader.join();
+		}
+	});
+
+	std::cerr << "(checksum " << checksum << ")" << std::endl;
+}
+
+// Copies, moves and assignments of one payload size under each tracing policy.
+template <typename Tracer>
+void runTracingCase(const std::string& label, size_t size, size_t operations) {
+	BasicBigData<Tracer> source(size, &countingResource);
+	BasicBigData<Tracer> target(size, &countingResource);
+	runCase(label, operations, [&] {
+		for (size_t i = 0; i < operations; ++i) {
+			BasicBigData<Tracer> copy(source, &countingResource);
+			BasicBigData<Tracer> moved(std::move(copy));
+			target = moved;
+			target = std::move(moved);
+		}
+	});
+}
+
+// Takes its argument by value: the kind of accidental copy the counters are meant to reveal.
+long long sumByValue(BasicBigData<BigDataCounting> data) {
+	return data.sum();
+}
+
+long long sumByReference(const BasicBigData<BigDataCounting>& data) {
+	return data.sum();
+}
+
+void benchmarkTracing(size_t size, size_t operations) {
+	std::cerr << "\n------ Tracing policies, " << size << " elements, " << operations << " x (copy, move, 2 assignments) ------\n" << std::endl;
+
+	runTracingCase<BigDataNoTracing>("No tracing", size, operations);
+	runTracingCase<BigDataCounting>("Per-thread counters", size, operations);
+	runTracingCase<BigDataLogging>("Logging to std::cout", size, operations);
+
+	std::cerr << "\nCounters around 1000 calls that take BigData by value, then 1000 by reference:" << std::endl;
+	BasicBigData<BigDataCounting> data(size);
+	long long checksum = 0;
+	BigDataCounters before = BigDataCounting::snapshot();
+	for (int i = 0; i < 1000; ++i) { checksum += sumByValue(data); }
+	BigDataCounters byValue = BigDataCounting::snapshot();
+	for (int i = 0; i < 1000; ++i) { checksum += sumByReference(data); }
+	BigDataCounters byReference = BigDataCounting::snapshot();
+	std::cerr << "By value: ";
+	BigDataCounting::report(std::cerr, byValue - before);
+	std::cerr << "By reference: ";
+	BigDataCounting::report(std::cerr, byReference - byValue);
+
+	// Counters of all threads, including exited ones, add up in a snapshot.
+	size_t threadCount = 4;
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&data] {
+			for (int i = 0; i < 1000; ++i) { BasicBigData<BigDataCounting> copy(data); }
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	BigDataCounters afterThreads = BigDataCounting::snapshot() - byReference;
+	std::cerr << "Copies made by " << threadCount << " threads: " << afterThreads.copies
+		<< (afterThreads.copies == threadCount * 1000 ? " (as expected)" : " (WRONG)") << std::endl;
+	std::cerr << "(checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t operations = argc > 1 ? std::stoull(argv[1]) : 200000;
+
+	// BigData logs every constructor and assignment; with std::cout's buffer removed those writes
+	// fail immediately, so mostly the memory handling is measured. Results go to std::cerr.
+	std::cout.rdbuf(nullptr);
+
+	for (size_t size : { 1, 4, 16, 17, 64, 1024, 65536 }) {
+		benchmarkSize(size, size >= 65536 ? operations / 20 : operations);
+	}
+
+	size_t bulkSize = argc > 2 ? std::stoull(argv[2]) : 32 * 1024 * 1024;
+	benchmarkBulkOperations(bulkSize);
+
+	benchmarkSharedCopies(65536, operations / 20);
+	std::cerr << "\nShared buffer stress check: " << (stressSharedBigData(8, 20000) ? "passed" : "FAILED") << std::endl;
+
+	benchmarkTracing(1024, operations);
+
+	return 0;
+}
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "container_format.h"
+#include "big_data_tracing.h"
+
+// Tracer is a tracing policy from big_data_tracing.h; BigData below uses the one chosen by the build flags.
+template <typename Tracer>
+class BasicBigData {
+private:
+	// Payloads of up to this many elements are stored inside the object, without a heap allocation.
+	static constexpr size_t INLINE_CAPACITY = 16;
+	// Storage starts on a cache-line boundary, so vectorized loops start on full lines.
+	static constexpr size_t ALIGNMENT = 64;
+	// Bulk operations on at least this many elements are split across hardware threads.
+	static constexpr size_t PARALLEL_THRESHOLD = size_t(1) << 22;
+
+	int* elements;
+	size_t size;
+	size_t capacity;
+	std::pmr::memory_resource* resource; // Where payloads larger than INLINE_CAPACITY are allocated.
+	alignas(ALIGNMENT) int inline_data[INLINE_CAPACITY];
+
+	bool usesInline() const {
+		return elements == inline_data;
+	}
+
+	// Points elements at storage for n elements: the inline buffer or a block from the memory resource.
+	void allocate(size_t n) {
+		if (n <= INLINE_CAPACITY) {
+			elements = inline_data;
+			capacity = INLINE_CAPACITY;
+		}
+		else {
+			elements = static_cast<int*>(resource->allocate(n * sizeof(int), ALIGNMENT));
+			Tracer::allocated(n * sizeof(int));
+			capacity = n;
+		}
+	}
+
+	void release() {
+		if (elements && !usesInline()) {
+			resource->deallocate(elements, capacity * sizeof(int), ALIGNMENT);
+		}
+		elements = nullptr;
+		capacity = 0;
+	}
+
+	// Takes over other's payload: steals a heap block, copies an inline one. Leaves other empty.
+	void steal(BasicBigData& other) noexcept {
+		resource = other.resource;
+		size = other.size;
+		if (other.usesInline()) {
+			elements = inline_data;
+			capacity = INLINE_CAPACITY;
+			std::copy(other.inline_data, other.inline_data + other.size, inline_data);
+		}
+		else {
+			elements = other.elements;
+			capacity = other.capacity;
+		}
+		other.elements = nullptr;
+		other.size = 0;
+		other.capacity = 0;
+	}
+
+	template <typename Op>
+	void transformAll(Op op) {
+		int* target = elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			transformRange(target + begin, end - begin, op);
+		});
+	}
+
+	void requireSameSize(const BasicBigData& other) const {
+		if (other.size != size) {
+			throw std::invalid_argument("BigData sizes do not match.");
+		}
+	}
+
+	// Elements per cache line. Loops run over whole lines with a fixed inner trip count, which compilers
+	// vectorize even at -O2, and finish the remainder one element at a time.
+	static constexpr size_t LINE_ELEMENTS = ALIGNMENT / sizeof(int);
+
+	// target[i] = op(target[i], source[i]) for i in [0, n). The ranges must not overlap.
+	template <typename Op>
+	static void transformRange(int* __restrict target, const int* __restrict source, size_t n, Op op) {
+		size_t i = 0;
+		for (; i + LINE_ELEMENTS <= n; i += LINE_ELEMENTS) {
+			for (size_t j = 0; j < LINE_ELEMENTS; ++j) {
+				target[i + j] = op(target[i + j], source[i + j]);
+			}
+		}
+		for (; i < n; ++i) {
+			target[i] = op(target[i], source[i]);
+		}
+	}
+
+	// target[i] = op(target[i]) for i in [0, n).
+	template <typename Op>
+	static void transformRange(int* __restrict target, size_t n, Op op) {
+		size_t i = 0;
+		for (; i + LINE_ELEMENTS <= n; i += LINE_ELEMENTS) {
+			for (size_t j = 0; j < LINE_ELEMENTS; ++j) {
+				target[i + j] = op(target[i + j]);
+			}
+		}
+		for (; i < n; ++i) {
+			target[i] = op(target[i]);
+		}
+	}
+
+	// Keeps one partial sum per lane of a cache line, so the additions are independent and vectorize.
+	static long long sumRange(const int* __restrict source, size_t n) {
+		long long lanes[LINE_ELEMENTS] = {};
+		size_t i = 0;
+		for (; i + LINE_ELEMENTS <= n; i += LINE_ELEMENTS) {
+			for (size_t j = 0; j < LINE_ELEMENTS; ++j) {
+				lanes[j] += source[i + j];
+			}
+		}
+		long long total = 0;
+		for (size_t j = 0; j < LINE_ELEMENTS; ++j) {
+			total += lanes[j];
+		}
+		for (; i < n; ++i) {
+			total += source[i];
+		}
+		return total;
+	}
+
+	// Runs body(begin, end) over [0, n): directly for small n, otherwise on one chunk per hardware thread.
+	// Chunk boundaries fall on cache lines, so threads never write to the same line.
+	template <typename Body>
+	static void forEachChunk(size_t n, Body body) {
+		// hardware_concurrency() can cost microseconds, so small sizes return before asking.
+		size_t threads = n < PARALLEL_THRESHOLD ? 1 : std::thread::hardware_concurrency();
+		if (threads <= 1) {
+			body(size_t(0), n);
+			return;
+		}
+
+		size_t chunk = ((n + threads - 1) / threads + LINE_ELEMENTS - 1) / LINE_ELEMENTS * LINE_ELEMENTS;
+		std::vector<std::thread> workers;
+		for (size_t begin = chunk; begin < n; begin += chunk) {
+			workers.emplace_back(body, begin, std::min(begin + chunk, n));
+		}
+		body(size_t(0), std::min(chunk, n));
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// Adds and multiplies as unsigned, so overflow wraps around instead of being undefined.
+	static int wrappingAdd(int left, int right) {
+		return static_cast<int>(static_cast<unsigned>(left) + static_cast<unsigned>(right));
+	}
+	static int wrappingMultiply(int left, int right) {
+		return static_cast<int>(static_cast<unsigned>(left) * static_cast<unsigned>(right));
+	}
+
+public:
+	BasicBigData(const size_t s, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: elements(nullptr), size(s), capacity(0), resource(memoryResource) {
+		Tracer::event(BigDataEvent::Construct);
+
+		allocate(size);
+		fill(0);
+	}
+
+	//    std::initializer_list
+	BasicBigData(std::initializer_list<int> initList, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: elements(nullptr), size(initList.size()), capacity(0), resource(memoryResource) {
+		Tracer::event(BigDataEvent::InitializerListConstruct);
+
+		allocate(size);
+		std::copy(initList.begin(), initList.end(), elements);
+	}
+
+	~BasicBigData() {
+		Tracer::event(BigDataEvent::Destroy);
+
+		release();
+	}
+
+	//  
+	// Like the std::pmr containers, a copy allocates from the default resource unless one is given.
+	BasicBigData(const BasicBigData& other, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: elements(nullptr), size(other.size), capacity(0), resource(memoryResource) {
+		Tracer::event(BigDataEvent::CopyConstruct);
+
+		allocate(size);
+		copyFrom(other);
+		Tracer::copied(size * sizeof(int));
+	}
+
+	//  
+	// Reuses the existing storage when it is large enough, and keeps this object's memory resource.
+	BasicBigData& operator=(const BasicBigData& other) {
+		Tracer::event(BigDataEvent::CopyAssign);
+
+		if (this != &other) {
+			if (other.size > capacity) {
+				// Allocates before releasing, so a failed allocation leaves this object unchanged.
+				int* newData = other.size <= INLINE_CAPACITY ? inline_data
+					: static_cast<int*>(resource->allocate(other.size * sizeof(int), ALIGNMENT));
+				if (newData != inline_data) { Tracer::allocated(other.size * sizeof(int)); }
+				release();
+				elements = newData;
+				capacity = std::max(other.size, INLINE_CAPACITY);
+			}
+			size = other.size;
+			copyFrom(other);
+			Tracer::copied(size * sizeof(int));
+		}
+		return *this;
+	}
+
+	//  
+	BasicBigData(BasicBigData&& other) noexcept {
+		Tracer::event(BigDataEvent::MoveConstruct);
+
+		steal(other);
+	}
+
+	//  
+	// The memory resource moves along with the payload, so no allocation (and no exception) is possible.
+	BasicBigData& operator=(BasicBigData&& other) noexcept {
+		Tracer::event(BigDataEvent::MoveAssign);
+
+		if (this != &other) {
+			release();
+			steal(other);
+		}
+		return *this;
+	}
+
+	int& operator[](size_t index){
+		if (index >= size) {
+			throw std::out_of_range("Index out of bounds.");
+		}
+		return elements[index];
+	}
+
+	const int& operator[](size_t index) const {
+		if (index >= size) {
+			throw std::out_of_range("Index out of bounds.");
+		}
+		return elements[index];
+	}
+
+	// Unchecked access for hot loops; the caller keeps indices below getSize().
+	int* data() {
+		return elements;
+	}
+	const int* data() const {
+		return elements;
+	}
+	int* begin() {
+		return elements;
+	}
+	int* end() {
+		return elements + size;
+	}
+	const int* begin() const {
+		return elements;
+	}
+	const int* end() const {
+		return elements + size;
+	}
+
+	// --- Bulk operations ---
+	// Vectorizable loops over cache-line blocks; huge buffers are additionally split across threads.
+	// Element-wise operations require both objects to have the same size.
+
+	void fill(int value) {
+		int* target = elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			transformRange(target + begin, end - begin, [value](int) { return value; });
+		});
+	}
+
+	void copyFrom(const BasicBigData& other) {
+		requireSameSize(other);
+		if (this == &other) { return; }
+		int* target = elements;
+		const int* source = other.elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			std::copy(source + begin, source + end, target + begin);
+		});
+	}
+
+	void addScalar(int value) {
+		int* target = elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			transformRange(target + begin, end - begin, [value](int element) { return wrappingAdd(element, value); });
+		});
+	}
+
+	void add(const BasicBigData& other) {
+		requireSameSize(other);
+		if (this == &other) {
+			transformAll([](int element) { return wrappingAdd(element, element); });
+			return;
+		}
+		int* target = elements;
+		const int* source = other.elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			transformRange(target + begin, source + begin, end - begin, [](int element, int operand) { return wrappingAdd(element, operand); });
+		});
+	}
+
+	void multiply(const BasicBigData& other) {
+		requireSameSize(other);
+		if (this == &other) {
+			transformAll([](int element) { return wrappingMultiply(element, element); });
+			return;
+		}
+		int* target = elements;
+		const int* source = other.elements;
+		forEachChunk(size, [=](size_t begin, size_t end) {
+			transformRange(target + begin, source + begin, end - begin, [](int element, int operand) { return wrappingMultiply(element, operand); });
+		});
+	}
+
+	// Sum of all elements, accumulated in 64 bits.
+	long long sum() const {
+		const int* source = elements;
+		std::atomic<long long> total{ 0 };
+		forEachChunk(size, [source, &total](size_t begin, size_t end) {
+			total.fetch_add(sumRange(source + begin, end - begin), std::memory_order_relaxed);
+		});
+		return total.load(std::memory_order_relaxed);
+	}
+
+	size_t getSize() const {
+		return size;
+	}
+
+	size_t getCapacity() const {
+		return capacity;
+	}
+
+	// True if the payload is stored inside the object (small-buffer optimization).
+	bool isInline() const {
+		return usesInline();
+	}
+
+	std::pmr::memory_resource* getResource() const {
+		return resource;
+	}
+
+	void print() const{
+		printContainer(std::cout, *this, { .open = "[", .close = "]" });
+		std::cout << std::endl;
+	}
+};
+
+using BigData = BasicBigData<BigDataTracing>;
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Lifecycle events reported by BasicBigData to its tracing policy.
+enum class BigDataEvent {
+	Construct,
+	InitializerListConstruct,
+	CopyConstruct,
+	CopyAssign,
+	MoveConstruct,
+	MoveAssign,
+	Destroy
+};
+
+// A tracing policy is a type with three static functions, called by every BasicBigData<Policy>:
+//   event(BigDataEvent)      - a constructor, assignment operator or the destructor ran;
+//   allocated(size_t bytes)  - a payload was allocated from the memory resource (inline storage is not reported);
+//   copied(size_t bytes)     - a copy constructor or copy assignment copied this many payload bytes.
+
+// Does nothing; every call compiles away.
+struct BigDataNoTracing {
+	static void event(BigDataEvent) {}
+	static void allocated(size_t) {}
+	static void copied(size_t) {}
+};
+
+// Prints a line to std::cout for every event, as the homework demonstration expects.
+struct BigDataLogging {
+	static void event(BigDataEvent event) {
+		switch (event) {
+		case BigDataEvent::Construct: std::cout << "Constructor has been called." << std::endl; break;
+		case BigDataEvent::InitializerListConstruct: std::cout << "Initializer_list constructor has been called." << std::endl; break;
+		case BigDataEvent::CopyConstruct: std::cout << "Copy constructor has been called." << std::endl; break;
+		case BigDataEvent::CopyAssign: std::cout << "Copy assignment operator has been called." << std::endl; break;
+		case BigDataEvent::MoveConstruct: std::cout << "Move constructor has been called." << std::endl; break;
+		case BigDataEvent::MoveAssign: std::cout << "Move assignment operator has been called." << std::endl; break;
+		case BigDataEvent::Destroy: std::cout << "Destructor has been called." << std::endl; break;
+		}
+	}
+	static void allocated(size_t) {}
+	static void copied(size_t) {}
+};
+
+// Totals of the events counted by BigDataCounting.
+struct BigDataCounters {
+	uint64_t constructions = 0;     // Constructions from a size or an initializer list.
+	uint64_t copies = 0;            // Copy constructions and copy assignments.
+	uint64_t moves = 0;             // Move constructions and move assignments.
+	uint64_t destructions = 0;
+	uint64_t allocations = 0;
+	uint64_t bytes_allocated = 0;
+	uint64_t bytes_copied = 0;
+
+	BigDataCounters& operator+=(const BigDataCounters& other) {
+		constructions += other.constructions;
+		copies += other.copies;
+		moves += other.moves;
+		destructions += other.destructions;
+		allocations += other.allocations;
+		bytes_allocated += other.bytes_allocated;
+		bytes_copied += other.bytes_copied;
+		return *this;
+	}
+
+	// What happened between two snapshots.
+	BigDataCounters operator-(const BigDataCounters& earlier) const {
+		BigDataCounters difference;
+		difference.constructions = constructions - earlier.constructions;
+		difference.copies = copies - earlier.copies;
+		difference.moves = moves - earlier.moves;
+		difference.destructions = destructions - earlier.destructions;
+		difference.allocations = allocations - earlier.allocations;
+		difference.bytes_allocated = bytes_allocated - earlier.bytes_allocated;
+		difference.bytes_copied = bytes_copied - earlier.bytes_copied;
+		return difference;
+	}
+};
+
+// Counts events in per-thread counters: a traced operation only increments a counter owned by its own
+// thread, with no locks and no shared cache lines. Snapshots add up the counters of all threads, including
+// the ones that have already exited.
+class BigDataCounting
+{
+private:
+	// One thread's counters. Only the owning thread writes them, so an increment is a plain load and store;
+	// they are atomic just so that snapshots may read them at the same time.
+	struct ThreadCounters {
+		std::atomic<uint64_t> constructions{ 0 };
+		std::atomic<uint64_t> copies{ 0 };
+		std::atomic<uint64_t> moves{ 0 };
+		std::atomic<uint64_t> destructions{ 0 };
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> bytes_allocated{ 0 };
+		std::atomic<uint64_t> bytes_copied{ 0 };
+
+		ThreadCounters() {
+			Registry& registry = Registry::instance();
+			std::lock_guard<std::mutex> lock(registry.registry_mutex);
+			registry.threads.push_back(this);
+		}
+		~ThreadCounters() {
+			Registry& registry = Registry::instance();
+			std::lock_guard<std::mutex> lock(registry.registry_mutex);
+			registry.retired += read();
+			std::erase(registry.threads, this);
+		}
+
+		BigDataCounters read() const {
+			BigDataCounters counters;
+			counters.constructions = constructions.load(std::memory_order_relaxed);
+			counters.copies = copies.load(std::memory_order_relaxed);
+			counters.moves = moves.load(std::memory_order_relaxed);
+			counters.destructions = destructions.load(std::memory_order_relaxed);
+			counters.allocations = allocations.load(std::memory_order_relaxed);
+			counters.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+			counters.bytes_copied = bytes_copied.load(std::memory_order_relaxed);
+			return counters;
+		}
+	};
+
+	struct Registry {
+		std::mutex registry_mutex;
+		std::vector<const ThreadCounters*> threads;
+		BigDataCounters retired; // Counters of threads that have exited.
+
+		static Registry& instance() {
+			static Registry registry;
+			return registry;
+		}
+	};
+
+	static ThreadCounters& local() {
+		thread_local ThreadCounters counters;
+		return counters;
+	}
+
+	static void increment(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+public:
+	static void event(BigDataEvent event) {
+		ThreadCounters& counters = local();
+		switch (event) {
+		case BigDataEvent::Construct:
+		case BigDataEvent::InitializerListConstruct: increment(counters.constructions); break;
+		case BigDataEvent::CopyConstruct:
+		case BigDataEvent::CopyAssign: increment(counters.copies); break;
+		case BigDataEvent::MoveConstruct:
+		case BigDataEvent::MoveAssign: increment(counters.moves); break;
+		case BigDataEvent::Destroy: increment(counters.destructions); break;
+		}
+	}
+
+	static void allocated(size_t bytes) {
+		ThreadCounters& counters = local();
+		increment(counters.allocations);
+		increment(counters.bytes_allocated, bytes);
+	}
+
+	static void copied(size_t bytes) {
+		increment(local().bytes_copied, bytes);
+	}
+
+	// Totals over all threads since the program started.
+	static BigDataCounters snapshot() {
+		Registry& registry = Registry::instance();
+		std::lock_guard<std::mutex> lock(registry.registry_mutex);
+		BigDataCounters total = registry.retired;
+		for (const ThreadCounters* counters : registry.threads) {
+			total += counters->read();
+		}
+		return total;
+	}
+
+	// Prints the counters; copies are what to look at when hunting for accidental ones.
+	static void report(std::ostream& out, const BigDataCounters& counters) {
+		out << "BigData trace:\n"
+			<< "  constructions:   " << std::setw(12) << counters.constructions << "\n"
+			<< "  copies:          " << std::setw(12) << counters.copies << "  (" << counters.bytes_copied << " bytes copied)\n"
+			<< "  moves:           " << std::setw(12) << counters.moves << "\n"
+			<< "  destructions:    " << std::setw(12) << counters.destructions << "\n"
+			<< "  allocations:     " << std::setw(12) << counters.allocations << "  (" << counters.bytes_allocated << " bytes)" << std::endl;
+	}
+
+	static void report(std::ostream& out) {
+		report(out, snapshot());
+	}
+};
+
+// Forwards every call to both policies, e.g. to log and count at the same time.
+template <typename First, typename Second>
+struct BigDataTracers {
+	static void event(BigDataEvent event) {
+		First::event(event);
+		Second::event(event);
+	}
+	static void allocated(size_t bytes) {
+		First::allocated(bytes);
+		Second::allocated(bytes);
+	}
+	static void copied(size_t bytes) {
+		First::copied(bytes);
+		Second::copied(bytes);
+	}
+};
+
+// The policy used by BigData, chosen at compile time: define BIGDATA_LOGGING to print every event and
+// BIGDATA_TRACING to count events, before including big_data.h. With neither, BigData is not instrumented.
+#if defined(BIGDATA_LOGGING) && defined(BIGDATA_TRACING)
+using BigDataTracing = BigDataTracers<BigDataLogging, BigDataCounting>;
+#elif defined(BIGDATA_LOGGING)
+using BigDataTracing = BigDataLogging;
+#elif defined(BIGDATA_TRACING)
+using BigDataTracing = BigDataCounting;
+#else
+using BigDataTracing = BigDataNoTracing;
+#endif
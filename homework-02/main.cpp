@@ -1,126 +1,18 @@
+// The demonstration shows every constructor, assignment and destructor call.
+#define BIGDATA_LOGGING
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
-
-class BigData {
-private:
-	int* data;
-	size_t size;
-
-public:
-	BigData(const size_t s) : size(s){
-		std::cout << "Constructor has been called." << std::endl;
-
-		data = new int[size]{};
-	}
-
-	//    std::initializer_list 
-	BigData(std::initializer_list<int> initList) : size(initList.size()) {
-		std::cout << "Initializer_list constructor has been called." << std::endl;
-
-		data = new int[size];
-		size_t i = 0;
-		for (int val : initList) {
-			data[i++] = val;
-		}
-	}
-
-	~BigData() {
-		std::cout << "Destructor has been called." << std::endl;
-
-		delete[] data;
-	}
-
-	//  
-	BigData(const BigData& other) : size(other.size) {
-		std::cout << "Copy constructor has been called." << std::endl;
-
-		data = new int[other.size];
-		for (size_t i = 0; i < other.size; i++){
-			data[i] = other.data[i];
-		}
-	}
-
-	//  
-	BigData& operator=(const BigData& other) {
-		std::cout << "Copy assignment operator has been called." << std::endl;
-
-		if (this != &other) {
-			delete[] data;
-
-			size = other.size;
-			data = new int[size];
-			for (size_t i = 0; i < other.size; i++) {
-				data[i] = other.data[i];
-			}
-		}
-		return *this;
-	}
-
-	//  
-	BigData(BigData&& other) noexcept {
-		std::cout << "Move constructor has been called." << std::endl;
-
-		this->data = other.data;
-		this->size = other.size;
-
-		other.data = nullptr;
-		other.size = 0;
-	}
-
-	//  
-	BigData& operator=(BigData&& other) noexcept {
-		std::cout << "Move assignment operator has been called." << std::endl;
-		
-		if (this != &other) {
-			delete[] data;
-
-			this->data = other.data;
-			this->size = other.size;
-
-			other.data = nullptr;
-			other.size = 0;
-		}
-		return *this;
-	}
-	
-	int& operator[](size_t index){
-		if (index >= size) {
-			throw std::out_of_range("Index out of bounds.");
-		}
-		return data[index];
-	}
-
-	const int& operator[](size_t index) const {
-		if (index >= size) {
-			throw std::out_of_range("Index out of bounds.");
-		}
-		return data[index];
-	}
-
-	void print() const{
-		std::cout << "[";
-		for (size_t i = 0; i < size; ++i) {
-			std::cout << data[i];
-			if (i < size - 1) {
-				std::cout << ", ";
-			}
-		}
-		std::cout << "]" << std::endl;
-	}
-};
+#include "container_format.h"
+#include "big_data.h"
+#include "shared_big_data.h"
 
 template <typename T>
 void printVec(std::vector<T>& vec)
 {
-	std::cout << "[";
-	for (size_t i = 0; i < vec.size(); ++i) {
-		std::cout << vec[i];
-		if (i < vec.size() - 1) {
-			std::cout << ", ";
-		}
-	}
-	std::cout << "]" << std::endl;
+	printContainer(std::cout, vec, { .open = "[", .close = "]" });
+	std::cout << std::endl;
 }
 
 int main() {
@@ -174,6 +66,31 @@ int main() {
 	std::cout << "accessData after modification: ";
 	accessData.print();
 
+	std::cout << "\n------ Small payloads and memory resources ------" << std::endl;
+	std::cout << "accessData (5 elements) is stored inline: " << std::boolalpha << accessData.isInline() << std::endl;
+
+	char arena[4096];
+	std::pmr::monotonic_buffer_resource arenaResource(arena, sizeof(arena));
+	BigData arenaData(100, &arenaResource);
+	std::cout << "arenaData (100 elements) is allocated from a stack arena, stored inline: " << arenaData.isInline() << std::endl;
+	arenaData = bigData;
+	std::cout << "arenaData after copying bigData keeps its capacity of " << arenaData.getCapacity() << " elements: ";
+	arenaData.print();
+
+	std::cout << "\n------ Copy-on-write sharing and slices ------" << std::endl;
+	SharedBigData sharedData(movedData);
+	SharedBigData sharedCopy = sharedData;
+	SharedBigData middle = sharedData.slice(3, 4);
+	std::cout << "sharedData, sharedCopy and middle share one buffer, use count: " << sharedData.useCount() << std::endl;
+	std::cout << "middle (elements 3..6): ";
+	middle.print();
+	sharedCopy.set(0, 100);
+	std::cout << "sharedCopy after writing index 0 (now a copy of its own): ";
+	sharedCopy.print();
+	std::cout << "sharedData (unchanged): ";
+	sharedData.print();
+	std::cout << "sharedData use count: " << sharedData.useCount() << std::endl;
+
 	std::cout << "\n---------- Lambda Expression Task ----------" << std::endl;
 	std::vector<int> vec = { 10, 20, 30, 40, 50 };
 	std::cout << "Original vector: ";
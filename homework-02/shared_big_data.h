@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include "container_format.h"
+#include "big_data.h"
+
+// Copy-on-write counterpart of BigData for data that is mostly read.
+// Copies and slices share one reference-counted buffer, so they cost O(1) whatever the size; the first write
+// through an object whose buffer is shared copies just that object's range into a buffer of its own.
+// As with std::shared_ptr, different objects sharing a buffer may be used from different threads at the same
+// time; a single object must not be modified concurrently.
+class SharedBigData {
+private:
+	// Lives at the start of the buffer's allocation; the elements follow after HEADER_SIZE bytes.
+	struct Header {
+		std::atomic<size_t> references;
+		size_t capacity;
+		std::pmr::memory_resource* resource;
+	};
+
+	static constexpr size_t ALIGNMENT = 64;
+	// Rounded up to a cache line, so the elements start on one, as they do in BigData.
+	static constexpr size_t HEADER_SIZE = (sizeof(Header) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+	Header* header;
+	size_t offset; // Where this object's range starts in the shared buffer.
+	size_t length;
+
+	static size_t allocationBytes(size_t capacity) {
+		return HEADER_SIZE + capacity * sizeof(int);
+	}
+
+	// A new buffer with a reference count of one. An empty range needs no buffer.
+	static Header* allocate(size_t capacity, std::pmr::memory_resource* resource) {
+		if (capacity == 0) { return nullptr; }
+		void* memory = resource->allocate(allocationBytes(capacity), ALIGNMENT);
+		return new (memory) Header{ { 1 }, capacity, resource };
+	}
+
+	int* elements() const {
+		return header ? reinterpret_cast<int*>(reinterpret_cast<char*>(header) + HEADER_SIZE) + offset : nullptr;
+	}
+
+	void retain() const {
+		if (header) {
+			// A new reference is always made from an existing one, so no ordering is needed.
+			header->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void release() {
+		// The last owner frees the buffer; acq_rel makes every other owner's writes visible before that.
+		if (header && header->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			std::pmr::memory_resource* resource = header->resource;
+			size_t bytes = allocationBytes(header->capacity);
+			header->~Header();
+			resource->deallocate(header, bytes, ALIGNMENT);
+		}
+		header = nullptr;
+	}
+
+	// Gives this object a buffer of its own before a write, copying only its range.
+	void detach() {
+		if (!header || header->references.load(std::memory_order_acquire) == 1) { return; }
+
+		Header* copy = allocate(length, header->resource);
+		std::copy(elements(), elements() + length, reinterpret_cast<int*>(reinterpret_cast<char*>(copy) + HEADER_SIZE));
+		release();
+		header = copy;
+		offset = 0;
+	}
+
+	void checkIndex(size_t index) const {
+		if (index >= length) {
+			throw std::out_of_range("Index out of bounds.");
+		}
+	}
+
+public:
+	explicit SharedBigData(size_t size = 0, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: header(allocate(size, memoryResource)), offset(0), length(size) {
+		std::fill(elements(), elements() + length, 0);
+	}
+
+	SharedBigData(std::initializer_list<int> initList, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: header(allocate(initList.size(), memoryResource)), offset(0), length(initList.size()) {
+		std::copy(initList.begin(), initList.end(), elements());
+	}
+
+	// Copies the payload of a BigData once; copies of the result share it from then on.
+	template <typename Tracer>
+	explicit SharedBigData(const BasicBigData<Tracer>& data, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: header(allocate(data.getSize(), memoryResource)), offset(0), length(data.getSize()) {
+		std::copy(data.begin(), data.end(), elements());
+	}
+
+	~SharedBigData() {
+		release();
+	}
+
+	SharedBigData(const SharedBigData& other) noexcept
+		: header(other.header), offset(other.offset), length(other.length) {
+		retain();
+	}
+
+	SharedBigData& operator=(const SharedBigData& other) noexcept {
+		if (this != &other) {
+			other.retain();
+			release();
+			header = other.header;
+			offset = other.offset;
+			length = other.length;
+		}
+		return *this;
+	}
+
+	SharedBigData(SharedBigData&& other) noexcept
+		: header(other.header), offset(other.offset), length(other.length) {
+		other.header = nullptr;
+		other.offset = 0;
+		other.length = 0;
+	}
+
+	SharedBigData& operator=(SharedBigData&& other) noexcept {
+		if (this != &other) {
+			release();
+			header = other.header;
+			offset = other.offset;
+			length = other.length;
+			other.header = nullptr;
+			other.offset = 0;
+			other.length = 0;
+		}
+		return *this;
+	}
+
+	// A view of `count` elements starting at `start` that shares this buffer; nothing is copied.
+	SharedBigData slice(size_t start, size_t count) const {
+		if (start > length || count > length - start) {
+			throw std::out_of_range("Slice out of bounds.");
+		}
+		SharedBigData view(*this);
+		view.offset += start;
+		view.length = count;
+		return view;
+	}
+
+	// Reads never copy.
+	const int& operator[](size_t index) const {
+		checkIndex(index);
+		return elements()[index];
+	}
+
+	// Writes copy the range first if the buffer is shared.
+	void set(size_t index, int value) {
+		checkIndex(index);
+		detach();
+		elements()[index] = value;
+	}
+
+	// Unchecked read access; valid until this object is modified or destroyed.
+	const int* data() const {
+		return elements();
+	}
+	const int* begin() const {
+		return elements();
+	}
+	const int* end() const {
+		return elements() + length;
+	}
+
+	// Unchecked write access. Detaches first, so other objects never see the writes.
+	int* mutableData() {
+		detach();
+		return elements();
+	}
+
+	size_t getSize() const {
+		return length;
+	}
+
+	// Number of objects (copies and slices) sharing this buffer, 0 for an empty object.
+	size_t useCount() const {
+		return header ? header->references.load(std::memory_order_acquire) : 0;
+	}
+
+	bool isShared() const {
+		return useCount() > 1;
+	}
+
+	void print() const {
+		printContainer(std::cout, *this, { .open = "[", .close = "]" });
+		std::cout << std::endl;
+	}
+};
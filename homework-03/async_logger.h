@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "file_manager.h"
+
+// What AsyncLogger::log does when the ring buffer is full.
+enum class OverflowPolicy {
+	Block, // Waits until the writer thread frees a slot.
+	Drop,  // Discards the record and counts it as dropped.
+	Grow   // Puts the record into an unbounded overflow queue (guarded by a mutex) until the ring catches up.
+};
+
+struct AsyncLoggerOptions {
+	size_t capacity = 65536;                      // Ring buffer slots, rounded up to a power of two.
+	OverflowPolicy overflow = OverflowPolicy::Block;
+	size_t batch_size = 4096;                     // Records the writer drains before checking for other work.
+	FileOptions file{ FileMode::Buffered, false };
+};
+
+struct AsyncLoggerMetrics {
+	uint64_t enqueued = 0;           // Records accepted by log().
+	uint64_t written = 0;            // Records handed to the FileManager.
+	uint64_t dropped = 0;            // Records discarded by OverflowPolicy::Drop.
+	uint64_t overflowed = 0;         // Records that went through the overflow queue (OverflowPolicy::Grow).
+	uint64_t batches = 0;            // Batches drained by the writer thread.
+	uint64_t latency_samples = 0;    // Enqueue latency is sampled on every 16th record of each thread.
+	double mean_enqueue_ns = 0.0;
+	uint64_t max_enqueue_ns = 0;
+};
+
+// Writes records to a file on a dedicated background thread.
+// Producers hand records over through a lock-free multi-producer/single-consumer ring buffer,
+// so they never wait for disk I/O; the writer thread drains the ring in batches.
+class AsyncLogger
+{
+private:
+	// One ring slot. `sequence` tells producers and the writer whose turn it is (Vyukov's bounded queue).
+	struct alignas(64) Slot {
+		std::atomic<size_t> sequence{ 0 };
+		std::string text;
+	};
+
+	static constexpr uint32_t LATENCY_SAMPLE_MASK = 15;
+	static constexpr int IDLE_SPINS = 64; // Rounds the writer yields before going to sleep, saving producers a wake-up call.
+
+	FileManager file;
+	AsyncLoggerOptions options;
+	std::vector<Slot> slots;
+	size_t mask;
+
+	alignas(64) std::atomic<size_t> enqueue_pos{ 0 };
+	alignas(64) size_t dequeue_pos = 0; // Owned by the writer thread.
+
+	std::mutex overflow_mutex;
+	std::deque<std::string> overflow;
+	std::atomic<size_t> overflow_size{ 0 };
+
+	alignas(64) std::atomic<uint32_t> wake{ 0 };
+	std::atomic<bool> writer_idle{ false };
+	std::atomic<bool> stopping{ false };
+	std::atomic<uint64_t> flush_requests{ 0 };
+	std::atomic<uint64_t> flush_completed{ 0 };
+
+	std::atomic<uint64_t> enqueued{ 0 };
+	std::atomic<uint64_t> written{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+	std::atomic<uint64_t> overflowed{ 0 };
+	std::atomic<uint64_t> batches{ 0 };
+	std::atomic<uint64_t> latency_samples{ 0 };
+	std::atomic<uint64_t> latency_total_ns{ 0 };
+	std::atomic<uint64_t> latency_max_ns{ 0 };
+
+	std::thread writer;
+
+	// Claims a free slot and copies the text into it. Returns false if the ring is full.
+	bool tryEnqueue(std::string_view text) {
+		size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+		while (true) {
+			Slot& slot = slots[pos & mask];
+			size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (difference == 0) {
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					slot.text.assign(text); // Reuses the slot's capacity, so steady-state logging does not allocate.
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0) {
+				return false;
+			}
+			else {
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Wakes the writer thread if it is waiting for work.
+	void wakeWriter() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (writer_idle.load(std::memory_order_relaxed)) {
+			wake.fetch_add(1, std::memory_order_release);
+			wake.notify_one();
+		}
+	}
+
+	// Writes up to batch_size records from the ring. Returns the number written.
+	size_t drainRing() {
+		size_t count = 0;
+		while (count < options.batch_size) {
+			Slot& slot = slots[dequeue_pos & mask];
+			if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) { break; }
+
+			file.write(std::string_view(slot.text));
+			slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+			++dequeue_pos;
+			++count;
+		}
+		if (count > 0) {
+			written.fetch_add(count, std::memory_order_relaxed);
+			batches.fetch_add(1, std::memory_order_relaxed);
+		}
+		return count;
+	}
+
+	// Writes every record up to (not including) ring position `target`. A slot that a producer has claimed
+	// but not yet filled is waited out: the producer is between claiming and publishing and finishes shortly.
+	size_t drainRingTo(size_t target) {
+		size_t count = 0;
+		while (dequeue_pos < target) {
+			size_t drained = drainRing();
+			if (drained == 0) { std::this_thread::yield(); }
+			count += drained;
+		}
+		return count;
+	}
+
+	// Writes everything in the overflow queue. A producer only puts records there after its earlier ones
+	// have claimed ring slots, so the ring is first drained up to the position reserved when the queue was
+	// taken; records of one producer keep their order. The position is read before the queue is marked empty,
+	// so records logged after a producer has seen it empty are not among them.
+	size_t drainOverflow() {
+		if (overflow_size.load(std::memory_order_acquire) == 0) { return 0; }
+
+		std::deque<std::string> pending;
+		size_t reserved;
+		{
+			std::lock_guard<std::mutex> lock(overflow_mutex);
+			pending.swap(overflow);
+			reserved = enqueue_pos.load(std::memory_order_acquire);
+			overflow_size.store(0, std::memory_order_release);
+		}
+		size_t count = drainRingTo(reserved);
+		for (const auto& text : pending) {
+			file.write(std::string_view(text));
+		}
+		written.fetch_add(pending.size(), std::memory_order_relaxed);
+		batches.fetch_add(1, std::memory_order_relaxed);
+		return count + pending.size();
+	}
+
+	bool ringEmpty() const {
+		return slots[dequeue_pos & mask].sequence.load(std::memory_order_acquire) != dequeue_pos + 1;
+	}
+
+	void writerLoop() {
+		int idle_rounds = 0;
+		while (true) {
+			// The flush request is read before draining: everything logged before it is visible now.
+			uint64_t requested = flush_requests.load(std::memory_order_acquire);
+			bool stop = stopping.load(std::memory_order_acquire);
+
+			size_t drained = 0;
+			while (size_t count = drainRing()) { drained += count; }
+			while (size_t count = drainOverflow()) {
+				drained += count;
+				while (size_t ringCount = drainRing()) { drained += ringCount; }
+			}
+
+			bool flushing = requested > flush_completed.load(std::memory_order_relaxed);
+			if (flushing || stop) {
+				// Every record logged before the request has claimed a position below this one, or is in the
+				// overflow queue; slots still being filled are waited for instead of stopping at them.
+				drained += drainRingTo(enqueue_pos.load(std::memory_order_acquire));
+				drained += drainOverflow();
+			}
+			if (flushing) {
+				file.flush();
+				flush_completed.store(requested, std::memory_order_release);
+				flush_completed.notify_all();
+			}
+			if (stop) { return; }
+
+			if (drained > 0) { idle_rounds = 0; }
+			if (idle_rounds++ < IDLE_SPINS) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Announces that it is going idle, then re-checks for work that raced with the announcement.
+			uint32_t observed = wake.load(std::memory_order_acquire);
+			writer_idle.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (ringEmpty() && overflow_size.load(std::memory_order_relaxed) == 0 &&
+				!stopping.load(std::memory_order_relaxed) &&
+				flush_requests.load(std::memory_order_relaxed) == flush_completed.load(std::memory_order_relaxed)) {
+				wake.wait(observed, std::memory_order_acquire);
+			}
+			writer_idle.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	void recordLatency(std::chrono::steady_clock::time_point start) {
+		uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count());
+		latency_samples.fetch_add(1, std::memory_order_relaxed);
+		latency_total_ns.fetch_add(ns, std::memory_order_relaxed);
+		uint64_t previous = latency_max_ns.load(std::memory_order_relaxed);
+		while (ns > previous && !latency_max_ns.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {}
+	}
+
+public:
+	explicit AsyncLogger(const char* name, const char* mode = "w", const AsyncLoggerOptions& loggerOptions = AsyncLoggerOptions())
+		: file(name, mode, loggerOptions.file), options(loggerOptions),
+		  slots(std::bit_ceil(std::max<size_t>(2, loggerOptions.capacity))), mask(slots.size() - 1) {
+		for (size_t i = 0; i < slots.size(); ++i) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		if (options.batch_size == 0) { options.batch_size = 1; }
+		writer = std::thread(&AsyncLogger::writerLoop, this);
+	}
+
+	// Writes every record logged so far, then closes the file.
+	~AsyncLogger() {
+		stopping.store(true, std::memory_order_release);
+		wake.fetch_add(1, std::memory_order_release);
+		wake.notify_one();
+		writer.join();
+	}
+
+	AsyncLogger(const AsyncLogger&) = delete;
+	AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+	// Queues one line for writing. Safe to call from any number of threads.
+	// Returns false only if the record was dropped (OverflowPolicy::Drop).
+	bool log(std::string_view text) {
+		thread_local uint32_t call_count = 0;
+		bool sampled = (call_count++ & LATENCY_SAMPLE_MASK) == 0;
+		auto start = sampled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+		bool useOverflow = options.overflow == OverflowPolicy::Grow && overflow_size.load(std::memory_order_acquire) > 0;
+		bool queued = !useOverflow && tryEnqueue(text);
+		while (!queued) {
+			if (options.overflow == OverflowPolicy::Drop) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			if (options.overflow == OverflowPolicy::Grow) {
+				{
+					std::lock_guard<std::mutex> lock(overflow_mutex);
+					overflow.emplace_back(text);
+					overflow_size.fetch_add(1, std::memory_order_release);
+				}
+				overflowed.fetch_add(1, std::memory_order_relaxed);
+				break;
+			}
+			// OverflowPolicy::Block: lets the writer catch up.
+			wakeWriter();
+			std::this_thread::yield();
+			queued = tryEnqueue(text);
+		}
+
+		enqueued.fetch_add(1, std::memory_order_release);
+		wakeWriter();
+		if (sampled) { recordLatency(start); }
+		return true;
+	}
+
+	// Blocks until every record logged before the call has been written and the file flushed.
+	void flush() {
+		uint64_t request = flush_requests.fetch_add(1, std::memory_order_acq_rel) + 1;
+		wake.fetch_add(1, std::memory_order_release);
+		wake.notify_one();
+
+		uint64_t completed = flush_completed.load(std::memory_order_acquire);
+		while (completed < request) {
+			flush_completed.wait(completed, std::memory_order_acquire);
+			completed = flush_completed.load(std::memory_order_acquire);
+		}
+	}
+
+	AsyncLoggerMetrics metrics() const {
+		AsyncLoggerMetrics snapshot;
+		snapshot.enqueued = enqueued.load(std::memory_order_relaxed);
+		snapshot.written = written.load(std::memory_order_relaxed);
+		snapshot.dropped = dropped.load(std::memory_order_relaxed);
+		snapshot.overflowed = overflowed.load(std::memory_order_relaxed);
+		snapshot.batches = batches.load(std::memory_order_relaxed);
+		snapshot.latency_samples = latency_samples.load(std::memory_order_relaxed);
+		snapshot.max_enqueue_ns = latency_max_ns.load(std::memory_order_relaxed);
+		if (snapshot.latency_samples > 0) {
+			snapshot.mean_enqueue_ns = static_cast<double>(latency_total_ns.load(std::memory_order_relaxed)) / snapshot.latency_samples;
+		}
+		return snapshot;
+	}
+};
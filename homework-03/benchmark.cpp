@@ -0,0 +1,582 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "async_logger.h"
+#include "bounded_readings_store.h"
+#include "file_manager.h"
+#include "readings_file.h"
+#include "readings_store.h"
+#include "streaming_stats.h"
+
+#ifdef _WIN32
+const char* NULL_DEVICE = "NUL";
+#else
+const char* NULL_DEVICE = "/dev/null";
+#endif
+
+const char* BENCHMARK_FILE = "benchmark_output.txt";
+
+// Builds log-like lines of varying length so that the benchmark does not write one repeated string.
+std::vector<std::string> makeLines(size_t count) {
+	std::vector<std::string> lines;
+	lines.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		lines.push_back("2024-06-01T12:00:00." + std::to_string(i % 1000) + "Z INFO sensor=" + std::to_string(i % 97)
+			+ " reading=" + std::to_string(i * 7919 % 100000) + " message=" + std::string(i % 40, 'x'));
+	}
+	return lines;
+}
+
+// FileManager as it was before FileOptions, kept as the baseline: fprintf per line and a console echo per write.
+class LegacyFileManager
+{
+private:
+	std::FILE* file_ptr;
+	std::string filename;
+public:
+	explicit LegacyFileManager(const char* name, const char* mode) : file_ptr(nullptr), filename(name) {
+		file_ptr = fopen(filename.c_str(), mode);
+		if (!file_ptr) {
+			throw std::runtime_error("Failed to open file " + filename);
+		}
+		std::cout << "File '" << filename << "' opened successfully in '" << mode << "' mode." << std::endl;
+	}
+	~LegacyFileManager() {
+		if (file_ptr){
+			if (fclose(file_ptr) == 0) {
+				std::cout << "File '" << filename << "' successfully closed." << std::endl;
+			}
+			else {
+				std::cerr << "Error closing file: '" << filename << "'." << std::endl;
+			}
+		}
+	}
+
+	void write(const char* text){
+		if (fprintf(file_ptr, "%s\n", text) < 0) {
+			std::cerr << "Error writing to file '" << filename << "': \"" << text << "\"" << std::endl;
+			return;
+		}
+		std::cout << "Written to file '" << filename << "': \"" << text << "\"" << std::endl;
+	}
+};
+
+// Times writeAll, which writes every line to BENCHMARK_FILE, and prints the throughput.
+void measureWrites(const std::string& label, const std::vector<std::string>& lines, const std::function<void()>& writeAll) {
+	size_t bytes = 0;
+	for (const auto& line : lines) { bytes += line.size() + 1; }
+
+	auto start = std::chrono::steady_clock::now();
+	writeAll();
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	// Results go to std::cerr, since std::cout is redirected to the null device while measuring.
+	std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(10) << bytes / seconds / (1024.0 * 1024.0) << " MB/s" << std::setw(10) << seconds * 1000.0 << " ms" << std::endl;
+}
+
+// Writes every line through a FileManager created with the given options and prints the throughput.
+void runCase(const std::string& label, const std::vector<std::string>& lines, const FileOptions& options) {
+	measureWrites(label, lines, [&] {
+		FileManager file(BENCHMARK_FILE, "w", options);
+		for (const auto& line : lines) {
+			file.write(std::string_view(line));
+		}
+	});
+}
+
+// Writes every line through LegacyFileManager and prints the throughput.
+void runLegacyCase(const std::string& label, const std::vector<std::string>& lines) {
+	measureWrites(label, lines, [&] {
+		LegacyFileManager file(BENCHMARK_FILE, "w");
+		for (const auto& line : lines) {
+			file.write(line.c_str());
+		}
+	});
+}
+
+// Counts lines by reading the file through a buffered fread loop.
+size_t countLinesWithFread(const char* path) {
+	std::FILE* file = std::fopen(path, "rb");
+	if (!file) { throw std::runtime_error("Failed to open file " + std::string(path)); }
+
+	std::vector<char> chunk(1 << 20);
+	size_t lines = 0;
+	size_t read = 0;
+	while ((read = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+		lines += std::count(chunk.begin(), chunk.begin() + read, '\n');
+	}
+	std::fclose(file);
+
+	return lines;
+}
+
+// Counts lines by scanning a read-only mapping of the file in place.
+size_t countLinesWithMapping(const char* path) {
+	FileOptions options;
+	options.mode = FileMode::Mapped;
+	options.echo = false;
+
+	FileManager file(path, "r", options);
+	file.advise(FileAccess::Sequential);
+	std::string_view contents = file.view();
+
+	return std::count(contents.begin(), contents.end(), '\n');
+}
+
+// Times one full read of the file and prints the throughput.
+void runReadCase(const std::string& label, size_t fileBytes, const std::function<size_t()>& readFile) {
+	auto start = std::chrono::steady_clock::now();
+	size_t lines = readFile();
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(10) << fileBytes / seconds / (1024.0 * 1024.0) << " MB/s" << std::setw(10) << seconds * 1000.0 << " ms"
+		<< "   lines: " << lines << std::endl;
+}
+
+// Writes a file of about the given size and compares reading it back with fread and with a mapping.
+// Both reads hit the page cache right after writing; drop the caches between runs to measure the disk.
+void benchmarkReads(size_t megabytes) {
+	std::cerr << "\n------ Reading a " << megabytes << " MiB file ------\n" << std::endl;
+
+	std::vector<std::string> lines = makeLines(10000);
+	size_t fileBytes = 0;
+	{
+		FileManager file(BENCHMARK_FILE, "w", { FileMode::Buffered, false, 8 * 1024 * 1024 });
+		for (size_t i = 0; fileBytes < megabytes * 1024 * 1024; ++i) {
+			const std::string& line = lines[i % lines.size()];
+			file.write(std::string_view(line));
+			fileBytes += line.size() + 1;
+		}
+	}
+
+	runReadCase("fread, 1 MiB buffer", fileBytes, [] { return countLinesWithFread(BENCHMARK_FILE); });
+	runReadCase("Mapped, sequential advice", fileBytes, [] { return countLinesWithMapping(BENCHMARK_FILE); });
+}
+
+// Prints one row of the logging benchmark: producer-side throughput, enqueue latency and drops.
+void printLoggerRow(const std::string& label, size_t records, double seconds, double meanNs, uint64_t maxNs, uint64_t dropped) {
+	std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(8) << records / seconds / 1e6 << " M rec/s" << std::setprecision(0)
+		<< std::setw(8) << meanNs << " ns mean" << std::setw(10) << maxNs << " ns max"
+		<< std::setw(10) << dropped << " dropped" << std::endl;
+}
+
+// Starts the given number of producer threads, each logging its share of the lines, and returns the elapsed seconds.
+double runProducers(size_t threads, const std::vector<std::string>& lines, const std::function<void(std::string_view)>& log) {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> producers;
+	for (size_t t = 0; t < threads; ++t) {
+		producers.emplace_back([&, t] {
+			for (size_t i = t; i < lines.size(); i += threads) {
+				log(lines[i]);
+			}
+		});
+	}
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compares producers sharing one FileManager behind a mutex with producers handing records to an AsyncLogger.
+void benchmarkAsyncLogger(const std::vector<std::string>& lines, size_t threads) {
+	std::cerr << "\n------ Logging from " << threads << " threads (" << lines.size() << " records) ------\n" << std::endl;
+
+	{
+		// Baseline: every producer waits for the lock and for the write itself.
+		FileManager file(BENCHMARK_FILE, "w", { FileMode::Buffered, false });
+		std::mutex fileMutex;
+		std::atomic<uint64_t> totalNs{ 0 };
+		std::atomic<uint64_t> maxNs{ 0 };
+		double seconds = runProducers(threads, lines, [&](std::string_view line) {
+			auto start = std::chrono::steady_clock::now();
+			{
+				std::lock_guard<std::mutex> lock(fileMutex);
+				file.write(line);
+			}
+			uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+			totalNs.fetch_add(ns, std::memory_order_relaxed);
+			uint64_t previous = maxNs.load(std::memory_order_relaxed);
+			while (ns > previous && !maxNs.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {}
+		});
+		printLoggerRow("FileManager + mutex (Buffered)", lines.size(), seconds, static_cast<double>(totalNs) / lines.size(), maxNs, 0);
+	}
+
+	struct LoggerCase {
+		const char* label;
+		OverflowPolicy overflow;
+		size_t capacity;
+	};
+	const LoggerCase cases[] = {
+		{ "AsyncLogger, Block, 64K slots", OverflowPolicy::Block, 65536 },
+		{ "AsyncLogger, Block, 1K slots", OverflowPolicy::Block, 1024 },
+		{ "AsyncLogger, Drop, 1K slots", OverflowPolicy::Drop, 1024 },
+		{ "AsyncLogger, Grow, 1K slots", OverflowPolicy::Grow, 1024 },
+	};
+	for (const auto& loggerCase : cases) {
+		AsyncLoggerOptions options;
+		options.overflow = loggerCase.overflow;
+		options.capacity = loggerCase.capacity;
+
+		AsyncLogger logger(BENCHMARK_FILE, "w", options);
+		double seconds = runProducers(threads, lines, [&](std::string_view line) { logger.log(line); });
+		AsyncLoggerMetrics metrics = logger.metrics();
+		printLoggerRow(loggerCase.label, lines.size(), seconds, metrics.mean_enqueue_ns, metrics.max_enqueue_ns, metrics.dropped);
+	}
+	std::cerr << "(Producer-side time: records still in the ring are written after the measurement, when the logger closes.)" << std::endl;
+}
+
+// Appends from several threads while a reader iterates, then checks that no reading was lost, duplicated
+// or reordered within its thread. The reader checks every pass the same way: a reading it sees that was not
+// fully written would decode to a writer or sequence number out of place.
+bool stressReadingsStore(size_t threads, size_t perThread) {
+	ReadingsStore store;
+	std::atomic<bool> writing{ true };
+	std::atomic<bool> readerSawBadValue{ false };
+
+	// Every reading encodes its writer and sequence number.
+	auto encode = [](size_t thread, size_t i) { return static_cast<int>(thread * 10000000 + i); };
+	// Checks that the readings are, for each writer, its first ones in order.
+	auto checkSequences = [threads, perThread](const auto& readings) {
+		std::vector<size_t> next(threads, 0);
+		bool ok = true;
+		readings([&](int value) {
+			size_t thread = static_cast<size_t>(value) / 10000000;
+			size_t i = static_cast<size_t>(value) % 10000000;
+			if (value < 0 || thread >= threads || i >= perThread || i != next[thread]++) { ok = false; }
+		});
+		return ok;
+	};
+
+	std::thread reader([&] {
+		while (writing.load(std::memory_order_acquire)) {
+			if (!checkSequences([&](const auto& visit) { store.forEach(visit); })) { readerSawBadValue = true; }
+		}
+	});
+	std::vector<std::thread> writers;
+	for (size_t t = 0; t < threads; ++t) {
+		writers.emplace_back([&, t] {
+			for (size_t i = 0; i < perThread; ++i) { store.append(encode(t, i)); }
+		});
+	}
+	for (auto& writer : writers) {
+		writer.join();
+	}
+	writing = false;
+	reader.join();
+
+	return store.size() == threads * perThread && !readerSawBadValue &&
+		checkSequences([&](const auto& visit) { for (int value : store) { visit(value); } });
+}
+
+// Compares appending from several threads to a mutex-guarded vector and to a ReadingsStore.
+void benchmarkReadingsStore(size_t threads, size_t perThread) {
+	std::cerr << "\n------ Appending readings from " << threads << " threads (" << threads * perThread << " readings) ------\n" << std::endl;
+	std::cerr << "Stress check (appends with a concurrent reader checking every pass): " << (stressReadingsStore(threads, 1000000) ? "passed" : "FAILED") << std::endl << std::endl;
+
+	auto runAppends = [&](const std::string& label, const std::function<void(int)>& append) {
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> writers;
+		for (size_t t = 0; t < threads; ++t) {
+			writers.emplace_back([&] {
+				for (size_t i = 0; i < perThread; ++i) { append(static_cast<int>(i)); }
+			});
+		}
+		for (auto& writer : writers) {
+			writer.join();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(8) << threads * perThread / seconds / 1e6 << " M readings/s" << std::endl;
+	};
+
+	{
+		std::vector<int> readings;
+		std::mutex readingsMutex;
+		runAppends("std::vector + mutex", [&](int value) {
+			std::lock_guard<std::mutex> lock(readingsMutex);
+			readings.push_back(value);
+		});
+	}
+	{
+		// ReadingsStore also folds every reading into its running statistics; this is the same work behind one lock.
+		std::vector<int> readings;
+		StreamingStats statistics;
+		std::mutex readingsMutex;
+		runAppends("std::vector + StreamingStats + mutex", [&](int value) {
+			std::lock_guard<std::mutex> lock(readingsMutex);
+			readings.push_back(value);
+			statistics.add(value);
+		});
+	}
+	{
+		ReadingsStore store;
+		runAppends("ReadingsStore (with statistics)", [&](int value) { store.append(value); });
+	}
+
+	// The share of an append that goes to the running statistics, folded in batches as ReadingsStore does.
+	std::vector<int> batch(64);
+	StreamingStats statistics;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < perThread; i += batch.size()) {
+		std::iota(batch.begin(), batch.end(), static_cast<int>(i));
+		statistics.add(batch.data(), batch.size());
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << "Of which folding into the statistics: " << std::fixed << std::setprecision(1) << seconds * 1e9 / perThread << " ns per reading and thread" << std::endl;
+}
+
+// Compares keeping every timestamped reading and scanning it with the bounded store's incremental rollups.
+void benchmarkRollups(size_t readingCount) {
+	using Clock = IReadingsStore::Clock;
+	std::cerr << "\n------ Bounded retention and rollups (" << readingCount << " readings at 100 Hz) ------\n" << std::endl;
+
+	auto start = std::chrono::floor<std::chrono::hours>(Clock::now());
+	auto timeOf = [start](size_t i) { return start + std::chrono::milliseconds(10 * i); };
+	auto valueOf = [](size_t i) { return static_cast<int>(i * 7919 % 1000); };
+	Clock::time_point end = timeOf(readingCount);
+	Clock::time_point hourAgo = end - std::chrono::hours(1);
+
+	auto printRow = [](const std::string& label, double seconds, size_t operations, const std::string& unit) {
+		std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(12) << seconds * 1e6 / operations << " " << unit << std::endl;
+	};
+
+	struct TimedReading {
+		Clock::time_point time;
+		int value;
+	};
+	std::vector<TimedReading> raw;
+	auto ingestStart = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < readingCount; ++i) { raw.push_back({ timeOf(i), valueOf(i) }); }
+	printRow("Raw vector: append", std::chrono::duration<double>(std::chrono::steady_clock::now() - ingestStart).count(), readingCount, "us/reading");
+
+	BoundedReadingsStore bounded(4096);
+	ingestStart = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < readingCount; ++i) { bounded.append(valueOf(i), timeOf(i)); }
+	printRow("Bounded store: append + rollups", std::chrono::duration<double>(std::chrono::steady_clock::now() - ingestStart).count(), readingCount, "us/reading");
+
+	const size_t QUERIES = 100;
+	double mean = 0.0;
+	auto queryStart = std::chrono::steady_clock::now();
+	for (size_t q = 0; q < QUERIES; ++q) {
+		int64_t sum = 0;
+		size_t count = 0;
+		for (const auto& reading : raw) {
+			if (reading.time >= hourAgo && reading.time < end) { sum += reading.value; ++count; }
+		}
+		mean = count > 0 ? static_cast<double>(sum) / count : 0.0;
+	}
+	printRow("Raw vector: last-hour mean (scan)", std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count(), QUERIES, "us/query");
+	std::cerr << "    mean " << mean << std::endl;
+
+	for (Resolution resolution : { Resolution::Second, Resolution::Minute }) {
+		RollupBucket summary;
+		queryStart = std::chrono::steady_clock::now();
+		for (size_t q = 0; q < QUERIES; ++q) { summary = bounded.summary(resolution, hourAgo, end); }
+		printRow(resolution == Resolution::Second ? "Bounded store: last-hour mean (seconds)" : "Bounded store: last-hour mean (minutes)",
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count(), QUERIES, "us/query");
+		std::cerr << "    mean " << summary.mean << std::endl;
+	}
+
+	std::cerr << "Memory: raw vector " << raw.capacity() * sizeof(TimedReading) / 1024 << " KiB, bounded store about "
+		<< (bounded.capacity() * sizeof(int) + (3600 + 24 * 60) * 32) / 1024 << " KiB (constant)" << std::endl;
+}
+
+// Compares recomputing statistics from a copy of the readings with the running statistics of a store,
+// and checks the t-digest quantiles against exact ones.
+void benchmarkStatistics(size_t readingCount) {
+	std::cerr << "\n------ Statistics over " << readingCount << " readings ------\n" << std::endl;
+
+	std::mt19937 generator(20240601);
+	std::lognormal_distribution<double> distribution(6.0, 0.8);
+	std::vector<int> input(readingCount);
+	for (auto& value : input) { value = static_cast<int>(distribution(generator)); }
+
+	auto seconds = [](std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	StreamingStats direct;
+	for (int value : input) { direct.add(value); }
+	std::cerr << std::left << std::setw(40) << "StreamingStats::add" << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(10) << seconds(start) * 1e9 / readingCount << " ns/reading" << std::endl;
+
+	ReadingsStore store;
+	for (int value : input) { store.append(value); }
+
+	// Exact answers from a copy of the readings, as a consumer had to compute them before.
+	start = std::chrono::steady_clock::now();
+	std::vector<int> copy;
+	store.forEach([&copy](int value) { copy.push_back(value); });
+	double mean = 0.0;
+	for (int value : copy) { mean += value; }
+	mean /= copy.size();
+	double variance = 0.0;
+	for (int value : copy) { variance += (value - mean) * (value - mean); }
+	variance /= copy.size() - 1;
+	double exact[3];
+	const double QUANTILES[3] = { 0.50, 0.90, 0.99 };
+	for (int i = 0; i < 3; ++i) {
+		size_t rank = static_cast<size_t>(QUANTILES[i] * (copy.size() - 1));
+		std::nth_element(copy.begin(), copy.begin() + rank, copy.end());
+		exact[i] = copy[rank];
+	}
+	std::cerr << std::left << std::setw(40) << "Copy and rescan" << std::right << std::setw(10) << seconds(start) * 1e3 << " ms/query" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	StatsSnapshot snapshot = store.stats(); // Merges the per-thread shards; the readings were folded in on append.
+	std::cerr << std::left << std::setw(40) << "stats()" << std::right << std::setw(10) << seconds(start) * 1e3 << " ms/query" << std::endl;
+
+	const size_t QUERIES = 1000;
+	start = std::chrono::steady_clock::now();
+	for (size_t q = 0; q < QUERIES; ++q) {
+		store.append(input[q]);
+		snapshot = store.stats();
+	}
+	std::cerr << std::left << std::setw(40) << "Append + stats()" << std::right << std::setw(10) << seconds(start) * 1e6 / QUERIES << " us/query" << std::endl;
+
+	std::cerr << std::setprecision(2) << "Exact:     mean " << mean << ", stddev " << std::sqrt(variance)
+		<< ", p50 " << exact[0] << ", p90 " << exact[1] << ", p99 " << exact[2] << std::endl;
+	std::cerr << "Streaming: mean " << snapshot.mean << ", stddev " << snapshot.stddev
+		<< ", p50 " << snapshot.p50 << ", p90 " << snapshot.p90 << ", p99 " << snapshot.p99 << std::endl;
+}
+
+// Compares storing readings as text lines with the binary readings file: size, writing, scanning and range queries.
+void benchmarkReadingsFile(size_t readingCount) {
+	std::cerr << "\n------ Persisting " << readingCount << " readings: text versus binary ------\n" << std::endl;
+	const char* TEXT_FILE = "benchmark_readings.txt";
+	const char* BINARY_FILE = "benchmark_readings.bin";
+
+	// A random walk, like a slowly drifting sensor signal.
+	std::mt19937 generator(20240601);
+	std::uniform_int_distribution<int> step(-20, 20);
+	std::vector<int> readings(readingCount);
+	int current = 1000;
+	for (auto& value : readings) { value = current += step(generator); }
+
+	auto seconds = [](std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+	auto printRow = [readingCount](const std::string& label, double elapsed, const std::string& extra) {
+		std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << readingCount / elapsed / 1e6 << " M readings/s" << "   " << extra << std::endl;
+	};
+	auto fileSize = [](const char* path) {
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		return static_cast<size_t>(in.tellg());
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		FileManager text(TEXT_FILE, "w", { FileMode::Buffered, false });
+		char digits[16];
+		for (int value : readings) {
+			auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			text.write(std::string_view(digits, result.ptr - digits));
+		}
+	}
+	double elapsed = seconds(start);
+	std::ostringstream textSize;
+	textSize << std::setprecision(2) << std::fixed << static_cast<double>(fileSize(TEXT_FILE)) / readingCount << " bytes/reading";
+	printRow("Write text lines", elapsed, textSize.str());
+
+	start = std::chrono::steady_clock::now();
+	{
+		ReadingsFileWriter binary(BINARY_FILE);
+		for (int value : readings) { binary.append(value); }
+	}
+	elapsed = seconds(start);
+	std::ostringstream binarySize;
+	binarySize << std::setprecision(2) << std::fixed << static_cast<double>(fileSize(BINARY_FILE)) / readingCount << " bytes/reading";
+	printRow("Write binary blocks", elapsed, binarySize.str());
+
+	int64_t expected = 0;
+	for (int value : readings) { expected += value; }
+
+	start = std::chrono::steady_clock::now();
+	int64_t textSum = 0;
+	{
+		FileManager text(TEXT_FILE, "r", { FileMode::Mapped, false });
+		std::string_view contents = text.view();
+		const char* position = contents.data();
+		const char* end = position + contents.size();
+		while (position < end) {
+			int value = 0;
+			position = std::from_chars(position, end, value).ptr + 1;
+			textSum += value;
+		}
+	}
+	printRow("Scan text (mapped, from_chars)", seconds(start), textSum == expected ? "sum ok" : "SUM MISMATCH");
+
+	start = std::chrono::steady_clock::now();
+	int64_t binarySum = 0;
+	ReadingsFileReader reader(BINARY_FILE);
+	reader.forEach([&binarySum](int value) { binarySum += value; });
+	printRow("Scan binary (mapped, decode)", seconds(start), binarySum == expected ? "sum ok" : "SUM MISMATCH");
+
+	// A narrow value band: most blocks are skipped or answered from their headers.
+	auto [minimum, maximum] = std::minmax_element(readings.begin(), readings.end());
+	int low = *minimum + (*maximum - *minimum) / 10;
+	int high = low + (*maximum - *minimum) / 20;
+	size_t exactCount = std::count_if(readings.begin(), readings.end(), [low, high](int value) { return value >= low && value <= high; });
+
+	start = std::chrono::steady_clock::now();
+	size_t rangeCount = reader.countInValueRange(low, high);
+	printRow("Binary value-range count (skips blocks)", seconds(start), rangeCount == exactCount ? "count ok" : "COUNT MISMATCH");
+
+	std::remove(TEXT_FILE);
+	std::remove(BINARY_FILE);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t lineCount = argc > 1 ? std::stoull(argv[1]) : 2000000;
+	size_t readMegabytes = argc > 2 ? std::stoull(argv[2]) : 4096;
+	std::vector<std::string> lines = makeLines(lineCount);
+
+	std::cerr << "------ FileManager write throughput (" << lineCount << " lines) ------\n" << std::endl;
+
+	// The per-write echo goes to the null device so that only its formatting cost is measured, not the terminal.
+	std::ofstream nullStream(NULL_DEVICE);
+	std::streambuf* consoleBuffer = std::cout.rdbuf(nullStream.rdbuf());
+
+	runLegacyCase("Previous FileManager (fprintf + echo)", lines);
+	runCase("Stream, echo on", lines, { FileMode::Stream, true });
+	runCase("Stream, echo off", lines, { FileMode::Stream, false });
+	runCase("Buffered 64 KiB, echo off", lines, { FileMode::Buffered, false, 64 * 1024 });
+	runCase("Buffered 1 MiB, echo off", lines, { FileMode::Buffered, false, 1024 * 1024 });
+	runCase("Buffered 8 MiB, echo off", lines, { FileMode::Buffered, false, 8 * 1024 * 1024 });
+	runCase("Mapped, echo off", lines, { FileMode::Mapped, false });
+
+	std::cout.rdbuf(consoleBuffer);
+
+	size_t threads = std::max(2u, std::thread::hardware_concurrency());
+	benchmarkAsyncLogger(lines, threads);
+	benchmarkReadingsStore(threads, 5000000);
+	benchmarkRollups(20000000);
+	benchmarkStatistics(10000000);
+	benchmarkReadingsFile(50000000);
+
+	benchmarkReads(readMegabytes);
+	std::remove(BENCHMARK_FILE);
+
+	return 0;
+}
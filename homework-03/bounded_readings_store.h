@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "readings_store.h"
+
+// Time resolution of the rollups kept by BoundedReadingsStore.
+enum class Resolution {
+	Second,
+	Minute
+};
+
+// Aggregate of the readings that fall into one time bucket (or a range of buckets).
+struct RollupBucket {
+	IReadingsStore::Clock::time_point start;
+	int min = 0;
+	int max = 0;
+	double mean = 0.0;
+	size_t count = 0;
+};
+
+// Keeps memory constant for long-running sensors: only the last `capacity` raw readings are retained
+// in a ring buffer, while per-second and per-minute min/max/mean buckets are updated on every insert.
+// Aggregated queries then visit buckets instead of scanning raw readings.
+class BoundedReadingsStore : public IReadingsStore
+{
+private:
+	// Running aggregate of one bucket. `tick` is the bucket's start in units of its resolution.
+	struct Bucket {
+		int64_t tick = std::numeric_limits<int64_t>::min();
+		int min = 0;
+		int max = 0;
+		int64_t sum = 0;
+		size_t count = 0;
+	};
+
+	// A ring of buckets of one resolution; bucket `tick` lives in slot tick % size.
+	struct RollupSeries {
+		int64_t seconds_per_bucket;
+		std::vector<Bucket> buckets;
+		int64_t newest_tick = std::numeric_limits<int64_t>::min();
+
+		RollupSeries(int64_t secondsPerBucket, size_t count) : seconds_per_bucket(secondsPerBucket), buckets(std::max<size_t>(count, 1)) {}
+
+		int64_t tickOf(Clock::time_point time) const {
+			int64_t seconds = std::chrono::floor<std::chrono::seconds>(time).time_since_epoch().count();
+			return seconds >= 0 ? seconds / seconds_per_bucket : (seconds - seconds_per_bucket + 1) / seconds_per_bucket;
+		}
+
+		Bucket& slot(int64_t tick) {
+			int64_t size = static_cast<int64_t>(buckets.size());
+			return buckets[static_cast<size_t>(((tick % size) + size) % size)];
+		}
+		const Bucket& slot(int64_t tick) const {
+			return const_cast<RollupSeries*>(this)->slot(tick);
+		}
+
+		void add(int value, Clock::time_point time) {
+			int64_t tick = tickOf(time);
+			int64_t size = static_cast<int64_t>(buckets.size());
+			if (newest_tick != std::numeric_limits<int64_t>::min() && tick <= newest_tick - size) {
+				return; // Older than anything still retained.
+			}
+			newest_tick = std::max(newest_tick, tick);
+
+			Bucket& bucket = slot(tick);
+			if (bucket.tick != tick) {
+				if (bucket.tick > tick) { return; } // The slot already holds a newer bucket.
+				bucket = Bucket{ tick, value, value, 0, 0 };
+			}
+			bucket.min = std::min(bucket.min, value);
+			bucket.max = std::max(bucket.max, value);
+			bucket.sum += value;
+			++bucket.count;
+		}
+
+		// Calls f for every non-empty retained bucket whose start lies in [from, to), oldest first.
+		template <typename F>
+		void forEachIn(Clock::time_point from, Clock::time_point to, F f) const {
+			if (newest_tick == std::numeric_limits<int64_t>::min() || to <= from) { return; }
+
+			int64_t size = static_cast<int64_t>(buckets.size());
+			int64_t first = std::max(tickOf(from), newest_tick - size + 1);
+			int64_t last = std::min(tickOf(to - Clock::duration(1)), newest_tick);
+			for (int64_t tick = first; tick <= last; ++tick) {
+				const Bucket& bucket = slot(tick);
+				if (bucket.tick == tick && bucket.count > 0) {
+					f(bucket);
+				}
+			}
+		}
+
+		RollupBucket toRollup(const Bucket& bucket) const {
+			RollupBucket rollup;
+			rollup.start = Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(bucket.tick * seconds_per_bucket)));
+			rollup.min = bucket.min;
+			rollup.max = bucket.max;
+			rollup.mean = static_cast<double>(bucket.sum) / bucket.count;
+			rollup.count = bucket.count;
+			return rollup;
+		}
+	};
+
+	mutable std::mutex store_mutex;
+	std::vector<int> values;
+	size_t head = 0;   // Slot the next reading goes into.
+	size_t total = 0;  // Readings ever added.
+	RollupSeries per_second;
+	RollupSeries per_minute;
+	StreamingStats statistics; // Covers every reading ever appended, including overwritten ones.
+
+	const RollupSeries& series(Resolution resolution) const {
+		return resolution == Resolution::Second ? per_second : per_minute;
+	}
+
+public:
+	// Retains the last `capacity` readings, one hour of per-second buckets and one day of per-minute buckets by default.
+	explicit BoundedReadingsStore(size_t capacity, size_t secondBuckets = 3600, size_t minuteBuckets = 24 * 60)
+		: values(capacity), per_second(1, secondBuckets), per_minute(60, minuteBuckets) {
+		if (capacity == 0) {
+			throw std::invalid_argument("BoundedReadingsStore capacity must be positive.");
+		}
+	}
+
+	void append(int value, Clock::time_point time) override {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		values[head] = value;
+		if (++head == values.size()) { head = 0; }
+		++total;
+		per_second.add(value, time);
+		per_minute.add(value, time);
+		statistics.add(value);
+	}
+
+	size_t size() const override {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		return std::min(total, values.size());
+	}
+
+	StatsSnapshot stats() const override {
+		return statistics.snapshot();
+	}
+
+	double quantile(double q) const override {
+		return statistics.quantile(q);
+	}
+
+	size_t capacity() const {
+		return values.size();
+	}
+
+	// Readings ever added, including those that have since been overwritten.
+	size_t totalAdded() const {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		return total;
+	}
+
+	void forEach(const std::function<void(int)>& f) const override {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		size_t count = std::min(total, values.size());
+		size_t start = total > values.size() ? head : 0;
+		for (size_t i = 0; i < count; ++i) {
+			size_t index = start + i;
+			f(values[index < values.size() ? index : index - values.size()]);
+		}
+	}
+
+	// Non-empty buckets of the given resolution that start in [from, to), oldest first.
+	std::vector<RollupBucket> rollups(Resolution resolution, Clock::time_point from, Clock::time_point to) const {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		const RollupSeries& levels = series(resolution);
+		std::vector<RollupBucket> result;
+		levels.forEachIn(from, to, [&](const Bucket& bucket) { result.push_back(levels.toRollup(bucket)); });
+		return result;
+	}
+
+	// Combined min/max/mean of all buckets of the given resolution that start in [from, to).
+	// The start of the result is the start of the first non-empty bucket.
+	RollupBucket summary(Resolution resolution, Clock::time_point from, Clock::time_point to) const {
+		std::lock_guard<std::mutex> lock(store_mutex);
+		const RollupSeries& levels = series(resolution);
+		Bucket combined;
+		levels.forEachIn(from, to, [&](const Bucket& bucket) {
+			if (combined.count == 0) {
+				combined = bucket;
+				return;
+			}
+			combined.min = std::min(combined.min, bucket.min);
+			combined.max = std::max(combined.max, bucket.max);
+			combined.sum += bucket.sum;
+			combined.count += bucket.count;
+		});
+		return combined.count > 0 ? levels.toRollup(combined) : RollupBucket{};
+	}
+};
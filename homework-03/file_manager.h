@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define FILE_MANAGER_HAS_WRITEV 1
+#define FILE_MANAGER_HAS_MMAP 1
+#endif
+
+// How FileManager::write gets text to the file.
+enum class FileMode {
+	Stream,   // Every write goes straight to the std::FILE* stream.
+	Buffered, // Writes are collected in a large user-space buffer and flushed in gathered batches.
+	Mapped    // The file is memory-mapped: "r" maps it read-only, other modes map it read-write
+	          // and write() appends into the mapping, growing the file in chunks.
+};
+
+// Access pattern hints passed to the kernel for a memory-mapped file.
+enum class FileAccess {
+	Normal,
+	Sequential, // Read ahead aggressively and drop pages soon after they are read.
+	Random,     // Do not read ahead.
+	WillNeed    // Start reading the whole mapping into memory now.
+};
+
+struct FileOptions {
+	FileMode mode = FileMode::Stream;
+	bool echo = true;                  // Prints a confirmation line to std::cout for every write.
+	size_t buffer_size = 1 << 20;      // Size of the user-space buffer in Buffered mode.
+	size_t map_chunk_size = 64 << 20;  // Step by which a writable mapping grows in Mapped mode.
+};
+
+class FileManager
+{
+private:
+	std::FILE* file_ptr;
+	std::string filename;
+	FileOptions options;
+	std::vector<char> buffer;
+	size_t buffered = 0;
+	std::byte* mapping = nullptr;  // Start of the mapped file in Mapped mode.
+	size_t mapped_size = 0;        // Length of the mapping (the file is grown to this size).
+	size_t data_size = 0;          // Bytes of actual content; the rest of the mapping is reserve.
+	bool map_writable = false;
+
+	// Maps the file opened as file_ptr (Mapped mode only).
+	void openMapping(const char* mode) {
+#ifdef FILE_MANAGER_HAS_MMAP
+		struct stat info;
+		if (fstat(fileno(file_ptr), &info) != 0) {
+			throw std::runtime_error("Failed to query size of file " + filename);
+		}
+		data_size = static_cast<size_t>(info.st_size);
+		map_writable = std::string_view(mode).find_first_of("wa+") != std::string_view::npos;
+
+		if (map_writable) {
+			remap(data_size + options.map_chunk_size);
+		}
+		else if (data_size > 0) {
+			void* address = mmap(nullptr, data_size, PROT_READ, MAP_SHARED, fileno(file_ptr), 0);
+			if (address == MAP_FAILED) {
+				throw std::runtime_error("Failed to map file " + filename);
+			}
+			mapping = static_cast<std::byte*>(address);
+			mapped_size = data_size;
+		}
+#else
+		(void)mode;
+		throw std::runtime_error("Memory-mapped files are not supported on this platform: " + filename);
+#endif
+	}
+
+	// Resizes the file to newSize bytes and maps it read-write again.
+	void remap(size_t newSize) {
+#ifdef FILE_MANAGER_HAS_MMAP
+		if (mapping) {
+			munmap(mapping, mapped_size);
+			mapping = nullptr;
+			mapped_size = 0;
+		}
+		if (ftruncate(fileno(file_ptr), static_cast<off_t>(newSize)) != 0) {
+			throw std::runtime_error("Failed to grow file " + filename);
+		}
+		void* address = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file_ptr), 0);
+		if (address == MAP_FAILED) {
+			throw std::runtime_error("Failed to map file " + filename);
+		}
+		mapping = static_cast<std::byte*>(address);
+		mapped_size = newSize;
+#else
+		(void)newSize;
+#endif
+	}
+
+	// Unmaps the file and cuts off the unused reserve at its end.
+	void closeMapping() {
+#ifdef FILE_MANAGER_HAS_MMAP
+		if (mapping) {
+			munmap(mapping, mapped_size);
+			mapping = nullptr;
+		}
+		if (map_writable && ftruncate(fileno(file_ptr), static_cast<off_t>(data_size)) != 0) {
+			std::cerr << "Error trimming file '" << filename << "'." << std::endl;
+		}
+#endif
+	}
+
+	// Appends raw bytes to a writable mapping, growing it by at least one chunk when full.
+	bool appendMapped(std::string_view text) {
+		if (!map_writable) { return false; }
+		if (text.empty()) { return true; }
+		if (data_size + text.size() > mapped_size) {
+			try {
+				remap(std::max(data_size + text.size(), mapped_size + options.map_chunk_size));
+			}
+			catch (const std::runtime_error&) {
+				return false;
+			}
+		}
+		std::memcpy(mapping + data_size, text.data(), text.size());
+		data_size += text.size();
+		return true;
+	}
+
+	// Writes all given segments to the file in as few system calls as possible.
+	bool writeSegments(const std::string_view* segments, size_t count) {
+#ifdef FILE_MANAGER_HAS_WRITEV
+		iovec vectors[3];
+		size_t used = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (!segments[i].empty()) {
+				vectors[used++] = { const_cast<char*>(segments[i].data()), segments[i].size() };
+			}
+		}
+
+		// writev may write only part of the data; continue from where it stopped.
+		iovec* current = vectors;
+		while (used > 0) {
+			ssize_t written = ::writev(fileno(file_ptr), current, static_cast<int>(used));
+			if (written < 0) {
+				if (errno == EINTR) { continue; }
+				return false;
+			}
+
+			size_t remaining = static_cast<size_t>(written);
+			while (used > 0 && remaining >= current->iov_len) {
+				remaining -= current->iov_len;
+				++current;
+				--used;
+			}
+			if (used > 0) {
+				current->iov_base = static_cast<char*>(current->iov_base) + remaining;
+				current->iov_len -= remaining;
+			}
+		}
+		return true;
+#else
+		for (size_t i = 0; i < count; ++i) {
+			if (fwrite(segments[i].data(), 1, segments[i].size(), file_ptr) != segments[i].size()) { return false; }
+		}
+		return true;
+#endif
+	}
+
+	// Flushes the buffer together with text (and an optional suffix) that does not fit into it.
+	bool flushWith(std::string_view text, std::string_view suffix) {
+		std::string_view segments[] = { std::string_view(buffer.data(), buffered), text, suffix };
+		buffered = 0;
+		return writeSegments(segments, 3);
+	}
+
+	// Appends the text and the suffix to the file in the current mode.
+	bool append(std::string_view text, std::string_view suffix) {
+		if (options.mode == FileMode::Buffered) {
+			if (text.size() + suffix.size() <= buffer.size() - buffered) {
+				std::copy(text.begin(), text.end(), buffer.begin() + buffered);
+				buffered += text.size();
+				std::copy(suffix.begin(), suffix.end(), buffer.begin() + buffered);
+				buffered += suffix.size();
+				return true;
+			}
+			return flushWith(text, suffix);
+		}
+		if (options.mode == FileMode::Mapped) {
+			return appendMapped(text) && appendMapped(suffix);
+		}
+		return fwrite(text.data(), 1, text.size(), file_ptr) == text.size() &&
+			(suffix.empty() || fwrite(suffix.data(), 1, suffix.size(), file_ptr) == suffix.size());
+	}
+
+public:
+	explicit FileManager(const char* name, const char* mode, const FileOptions& fileOptions = FileOptions())
+		: file_ptr(nullptr), filename(name), options(fileOptions) {
+		std::string open_mode = mode;
+		if (options.mode == FileMode::Mapped && open_mode.find_first_of("wa") != std::string::npos && open_mode.find('+') == std::string::npos) {
+			open_mode += '+'; // A shared writable mapping needs a descriptor opened for reading too.
+		}
+		file_ptr = fopen(filename.c_str(), open_mode.c_str());
+		if (!file_ptr) {
+			throw std::runtime_error("Failed to open file " + filename);
+		}
+		if (options.mode == FileMode::Buffered) {
+			// Our own buffer replaces the stdio one, so the data is not copied twice.
+			setvbuf(file_ptr, nullptr, _IONBF, 0);
+			buffer.resize(options.buffer_size > 0 ? options.buffer_size : 1);
+		}
+		if (options.mode == FileMode::Mapped) {
+			try {
+				openMapping(mode);
+			}
+			catch (const std::runtime_error&) {
+				fclose(file_ptr);
+				throw;
+			}
+		}
+		if (options.echo) {
+			std::cout << "File '" << filename << "' opened successfully in '" << mode << "' mode." << std::endl;
+		}
+	}
+	~FileManager() {
+		if (file_ptr){
+			flush();
+			closeMapping();
+			if (fclose(file_ptr) == 0) {
+				if (options.echo) {
+					std::cout << "File '" << filename << "' successfully closed." << std::endl;
+				}
+			}
+			else {
+				std::cerr << "Error closing file: '" << filename << "'." << std::endl;
+			}
+		}
+	}
+
+	FileManager(const FileManager&) = delete;
+	FileManager& operator=(const FileManager&) = delete;
+
+	void write(const char* text) {
+		write(std::string_view(text));
+	}
+
+	// Writes the text followed by a newline. The text is copied as-is, without any format parsing.
+	void write(std::string_view text) {
+		if (!append(text, "\n")) {
+			std::cerr << "Error writing to file '" << filename << "': \"" << text << "\"" << std::endl;
+			return;
+		}
+		if (options.echo) {
+			std::cout << "Written to file '" << filename << "': \"" << text << "\"" << std::endl;
+		}
+	}
+
+	// Writes raw bytes, without a newline or console echo; for binary formats.
+	void writeBytes(std::span<const std::byte> data) {
+		if (!append(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()), {})) {
+			std::cerr << "Error writing " << data.size() << " bytes to file '" << filename << "'." << std::endl;
+		}
+	}
+
+	// Pushes everything written so far to the operating system.
+	void flush() {
+		bool ok = true;
+		if (options.mode == FileMode::Buffered) {
+			if (buffered > 0) {
+				std::string_view pending(buffer.data(), buffered);
+				buffered = 0;
+				ok = writeSegments(&pending, 1);
+			}
+		}
+		else if (options.mode == FileMode::Mapped) {
+#ifdef FILE_MANAGER_HAS_MMAP
+			ok = !mapping || !map_writable || msync(mapping, mapped_size, MS_ASYNC) == 0;
+#endif
+		}
+		else {
+			ok = fflush(file_ptr) == 0;
+		}
+
+		if (!ok) {
+			std::cerr << "Error flushing file '" << filename << "'." << std::endl;
+		}
+	}
+
+	// Contents of a memory-mapped file, readable without copying. Valid until the next write() or destruction.
+	std::span<const std::byte> bytes() const {
+		if (options.mode != FileMode::Mapped) {
+			throw std::runtime_error("File '" + filename + "' is not memory-mapped.");
+		}
+		return { mapping, data_size };
+	}
+
+	// Same contents as bytes(), viewed as text for zero-copy parsing.
+	std::string_view view() const {
+		std::span<const std::byte> contents = bytes();
+		return { reinterpret_cast<const char*>(contents.data()), contents.size() };
+	}
+
+	// Writable contents of a file mapped in a read-write mode, for in-place updates.
+	std::span<std::byte> mutableBytes() {
+		if (options.mode != FileMode::Mapped || !map_writable) {
+			throw std::runtime_error("File '" + filename + "' is not mapped for writing.");
+		}
+		return { mapping, data_size };
+	}
+
+	// Tells the kernel how the mapping is going to be accessed.
+	void advise(FileAccess access) {
+		if (options.mode != FileMode::Mapped) {
+			throw std::runtime_error("File '" + filename + "' is not memory-mapped.");
+		}
+#ifdef FILE_MANAGER_HAS_MMAP
+		if (!mapping) { return; }
+
+		int advice = MADV_NORMAL;
+		switch (access) {
+		case FileAccess::Normal: advice = MADV_NORMAL; break;
+		case FileAccess::Sequential: advice = MADV_SEQUENTIAL; break;
+		case FileAccess::Random: advice = MADV_RANDOM; break;
+		case FileAccess::WillNeed: advice = MADV_WILLNEED; break;
+		}
+		if (madvise(mapping, mapped_size, advice) != 0) {
+			std::cerr << "Error advising kernel about file '" << filename << "'." << std::endl;
+		}
+#else
+		(void)access;
+#endif
+	}
+};
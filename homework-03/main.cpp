@@ -1,95 +1,59 @@
+#include <chrono>
 #include <iostream>
+#include <thread>
 #include <vector>
+#include "async_logger.h"
+#include "bounded_readings_store.h"
+#include "file_manager.h"
+#include "sensor.h"
 
-class FileManager
+int main()
 {
-private:
-	std::FILE* file_ptr;
-	std::string filename;
-public:
-	explicit FileManager(const char* name, const char* mode) : filename(name), file_ptr(nullptr) {
-		file_ptr = fopen(filename.c_str(), mode);
-		if (!file_ptr) {
-			throw std::runtime_error("Failed to open file " + filename);
-		}
-		std::cout << "File '" << filename << "' opened successfully in '" << mode << "' mode." << std::endl;
-	}
-	~FileManager() {
-		if (file_ptr){
-			if (fclose(file_ptr) == 0) {
-				std::cout << "File '" << filename << "' successfully closed." << std::endl;
-			}
-			else {
-				std::cerr << "Error closing file: '" << filename << "'." << std::endl;
-			}
-		}
-	}
+	std::cout << "----------- Task 1: writing to a file -----------\n" << std::endl;
 
-	void write(const char* text){
-		if (fprintf(file_ptr, "%s\n", text) < 0) {
-			std::cerr << "Error writing to file '" << filename << "': \"" << text << "\"" << std::endl;
-			return;
-		}
-		std::cout << "Written to file '" << filename << "': \"" << text << "\"" << std::endl;
+	try{
+		FileManager myFile("note.txt", "w");
+		myFile.write("Hello world!");
 	}
-};
-
-class Sensor
-{
-private:
-	std::shared_ptr<std::vector<int>> readings;
-	std::string sensor_name;
-public:
-	Sensor(const std::string& name, std::shared_ptr<std::vector<int>> shared_readings = nullptr)
-		: sensor_name(name) {
-		if (shared_readings) {
-			readings = shared_readings;
-		}
-		else {
-			readings = std::make_shared<std::vector<int>>();
-		}
-		std::cout << "Sensor '" << sensor_name << "' created. Readings are shared (" << readings.use_count() << " owner" << (readings.use_count() > 1 ? "s" : "") << ")." << std::endl;
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
 	}
 
-	void addReading(int value) {
-		if (readings) {
-			readings->push_back(value);
-			std::cout << "Sensor '" << sensor_name << "': Added readings " << value << "." << std::endl;
-		}
-		else {
-			std::cerr << "Sensor '" << sensor_name << "': There is no valid vector to add readings to." << std::endl;
-		}
-	}
+	std::cout << "\n------- Task 1b: buffered writing without console echo -------\n" << std::endl;
 
-	void printReadings() const {
-		if (readings && !readings->empty()) {
-			std::cout << "Sensor '" << sensor_name << "' readings (" << readings.use_count() << " owners): [";
-			for (size_t i = 0; i < readings->size(); ++i) {
-				std::cout << (*readings)[i];
-				if (i < readings->size() - 1) {
-					std::cout << ", ";
-				}
-			}
-			std::cout << "]" << std::endl;
-		}
-		else {
-			std::cout << "Sensor '" << sensor_name << "': No readings." << std::endl;
+	try{
+		FileManager logFile("log.txt", "w", { FileMode::Buffered, false });
+		for (int i = 1; i <= 1000; ++i) {
+			logFile.write("Log line #" + std::to_string(i));
 		}
+		std::cout << "Written 1000 lines to 'log.txt' through a single buffered flush." << std::endl;
 	}
-
-	const auto get_name()
+	catch (const std::runtime_error& e)
 	{
-		return sensor_name;
+		std::cerr << "Error: " << e.what() << std::endl;
 	}
-};
 
-int main()
-{
-	std::cout << "----------- Task 1: writing to a file -----------\n" << std::endl;
+	std::cout << "\n------- Task 1c: asynchronous logging from several threads -------\n" << std::endl;
 
 	try{
-		FileManager myFile("note.txt", "w");
-		myFile.write("Hello world!");
+		AsyncLogger logger("async_log.txt");
+		std::vector<std::thread> producers;
+		for (int t = 1; t <= 4; ++t) {
+			producers.emplace_back([&logger, t] {
+				for (int i = 1; i <= 1000; ++i) {
+					logger.log("Thread " + std::to_string(t) + ", line #" + std::to_string(i));
+				}
+			});
+		}
+		for (auto& producer : producers) {
+			producer.join();
+		}
+		logger.flush();
+
+		AsyncLoggerMetrics metrics = logger.metrics();
+		std::cout << "Written " << metrics.written << " lines to 'async_log.txt' in " << metrics.batches << " batches ("
+				  << metrics.dropped << " dropped, mean enqueue " << metrics.mean_enqueue_ns << " ns)." << std::endl;
 	}
 	catch (const std::runtime_error& e)
 	{
@@ -99,8 +63,8 @@ int main()
 	std::cout << "\n------------------ Task 2: Sensor class ------------------\n" << std::endl
 			  << "---------------- Test 1: with shared data ----------------\n" << std::endl;
 	
-	std::shared_ptr<std::vector<int>> sharedSensorData(new std::vector<int>());
-	std::cout << "Created shared readings vector (owner count: " << sharedSensorData.use_count() << ").\n" << std::endl;
+	std::shared_ptr<ReadingsStore> sharedSensorData = std::make_shared<ReadingsStore>();
+	std::cout << "Created shared readings store (owner count: " << sharedSensorData.use_count() << ").\n" << std::endl;
 
 	Sensor sensorA("Sensor A", sharedSensorData);
 	std::cout << "sharedSensorData.use_count() after creating " << sensorA.get_name() << ": " << sharedSensorData.use_count() << std::endl << std::endl;
@@ -131,5 +95,56 @@ int main()
 	sensorC.addReading(100);
 	sensorC.printReadings();
 
+	std::cout << "\n------- Test 3: sensors sharing readings across threads -------\n" << std::endl;
+
+	std::shared_ptr<ReadingsStore> concurrentData = std::make_shared<ReadingsStore>();
+	{
+		Sensor sensorD("Sensor D", concurrentData);
+		Sensor sensorE("Sensor E", concurrentData);
+
+		// The per-reading message goes to the null stream here, so that only the appends run concurrently.
+		std::streambuf* consoleBuffer = std::cout.rdbuf(nullptr);
+		std::thread writerD([&sensorD] { for (int i = 0; i < 10000; ++i) { sensorD.addReading(i); } });
+		std::thread writerE([&sensorE] { for (int i = 0; i < 10000; ++i) { sensorE.addReading(-i); } });
+		writerD.join();
+		writerE.join();
+		std::cout.rdbuf(consoleBuffer);
+		sensorD.printStatistics();
+
+		try{
+			sensorD.saveReadings("readings.bin");
+			ReadingsFileReader savedReadings("readings.bin");
+			std::cout << "'readings.bin' holds " << savedReadings.size() << " readings in " << savedReadings.blockCount() << " blocks; "
+					  << savedReadings.countInValueRange(0, 9999) << " of them are non-negative." << std::endl;
+		}
+		catch (const std::runtime_error& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+		}
+	}
+	std::cout << "Two threads added " << concurrentData->size() << " readings to the shared store." << std::endl;
+
+	std::cout << "\n------- Test 4: bounded retention with rollups -------\n" << std::endl;
+
+	std::shared_ptr<BoundedReadingsStore> boundedData = std::make_shared<BoundedReadingsStore>(5);
+	{
+		Sensor sensorF("Sensor F", boundedData);
+
+		// Replays three minutes of one reading per second; only the last 5 raw readings are kept.
+		std::streambuf* consoleBuffer = std::cout.rdbuf(nullptr);
+		auto start = std::chrono::floor<std::chrono::minutes>(IReadingsStore::Clock::now());
+		for (int second = 0; second < 180; ++second) {
+			sensorF.addReading(second % 60, start + std::chrono::seconds(second));
+		}
+		std::cout.rdbuf(consoleBuffer);
+
+		sensorF.printReadings();
+		std::cout << boundedData->totalAdded() << " readings added, " << boundedData->size() << " retained." << std::endl;
+		for (const auto& minute : boundedData->rollups(Resolution::Minute, start, start + std::chrono::minutes(3))) {
+			std::cout << "Minute bucket: min " << minute.min << ", max " << minute.max << ", mean " << minute.mean << " (" << minute.count << " readings)" << std::endl;
+		}
+		sensorF.printStatistics();
+	}
+
 	return 0;
 }
\ No newline at end of file
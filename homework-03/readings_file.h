@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "file_manager.h"
+
+// Binary file format for sensor readings:
+//
+//   FileHeader | BlockHeader payload | BlockHeader payload | ...
+//
+// Readings are stored in blocks of up to `block_size` readings. A block keeps its first reading and the
+// differences between neighbours, zigzag-encoded and bit-packed with the width of the largest one, so a
+// slowly changing signal takes a few bits per reading. The header's min/max let readers skip whole blocks.
+// All fields are little-endian.
+static_assert(std::endian::native == std::endian::little, "The readings file format is implemented for little-endian targets.");
+
+struct ReadingsFileHeader {
+	char magic[4] = { 'R', 'D', 'G', 'S' };
+	uint32_t version = 1;
+	uint32_t block_size = 0;  // Maximum number of readings per block.
+	uint32_t reserved = 0;
+};
+
+struct ReadingsBlockHeader {
+	uint32_t count = 0;         // Readings in this block.
+	uint32_t payload_bytes = 0; // Bytes of bit-packed deltas that follow the header.
+	int32_t min = 0;
+	int32_t max = 0;
+	int32_t first = 0;          // The first reading; the payload holds the count - 1 deltas after it.
+	uint8_t bit_width = 0;      // Bits per packed delta.
+	uint8_t reserved[3] = {};
+};
+
+static_assert(sizeof(ReadingsFileHeader) == 16 && sizeof(ReadingsBlockHeader) == 24, "Readings file headers must not contain padding.");
+
+// Every payload ends with this many zero bytes, so decoding can always load 8 bytes at once.
+constexpr size_t READINGS_PAYLOAD_PADDING = 8;
+
+// Streams readings into a binary readings file, one encoded block at a time.
+class ReadingsFileWriter
+{
+private:
+	FileManager file;
+	uint32_t block_size;
+	std::vector<int> pending;
+	std::vector<std::byte> encoded;
+	size_t total = 0;
+	bool closed = false;
+
+	static uint64_t zigzag(int64_t delta) {
+		return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+	}
+
+	void writeBlock() {
+		if (pending.empty()) { return; }
+
+		ReadingsBlockHeader header;
+		header.count = static_cast<uint32_t>(pending.size());
+		header.first = pending.front();
+		auto [minimum, maximum] = std::minmax_element(pending.begin(), pending.end());
+		header.min = *minimum;
+		header.max = *maximum;
+
+		uint64_t widest = 0;
+		for (size_t i = 1; i < pending.size(); ++i) {
+			widest |= zigzag(static_cast<int64_t>(pending[i]) - pending[i - 1]);
+		}
+		header.bit_width = static_cast<uint8_t>(std::bit_width(widest));
+		size_t bits = (pending.size() - 1) * header.bit_width;
+		header.payload_bytes = header.bit_width == 0 ? 0 : static_cast<uint32_t>((bits + 7) / 8 + READINGS_PAYLOAD_PADDING);
+
+		encoded.assign(sizeof(header) + header.payload_bytes, std::byte{ 0 });
+		std::memcpy(encoded.data(), &header, sizeof(header));
+		std::byte* payload = encoded.data() + sizeof(header);
+		// A delta is at most 33 bits wide, so together with its bit offset it always fits into one 64-bit word.
+		for (size_t i = 1, bit = 0; header.bit_width > 0 && i < pending.size(); ++i, bit += header.bit_width) {
+			uint64_t word;
+			std::memcpy(&word, payload + bit / 8, sizeof(word));
+			word |= zigzag(static_cast<int64_t>(pending[i]) - pending[i - 1]) << (bit % 8);
+			std::memcpy(payload + bit / 8, &word, sizeof(word));
+		}
+
+		file.writeBytes(encoded);
+		pending.clear();
+	}
+
+public:
+	explicit ReadingsFileWriter(const char* path, uint32_t blockSize = 1024)
+		: file(path, "wb", { FileMode::Buffered, false }), block_size(std::max<uint32_t>(blockSize, 1)) {
+		ReadingsFileHeader header;
+		header.block_size = block_size;
+		file.writeBytes(std::as_bytes(std::span<const ReadingsFileHeader>(&header, 1)));
+		pending.reserve(block_size);
+	}
+	~ReadingsFileWriter() {
+		close();
+	}
+
+	ReadingsFileWriter(const ReadingsFileWriter&) = delete;
+	ReadingsFileWriter& operator=(const ReadingsFileWriter&) = delete;
+
+	void append(int value) {
+		if (closed) {
+			throw std::runtime_error("Cannot append to a closed readings file.");
+		}
+		pending.push_back(value);
+		++total;
+		if (pending.size() == block_size) { writeBlock(); }
+	}
+
+	// Writes the last, partially filled block and flushes the file. Called by the destructor.
+	void close() {
+		if (closed) { return; }
+		writeBlock();
+		file.flush();
+		closed = true;
+	}
+
+	size_t size() const {
+		return total;
+	}
+};
+
+// Reads a binary readings file through a read-only memory mapping.
+// Only the block headers are read on opening; blocks are decoded on demand, and range queries
+// skip every block whose index range or min/max cannot match.
+class ReadingsFileReader
+{
+private:
+	struct BlockInfo {
+		size_t offset;      // Offset of the payload in the file.
+		size_t first_index; // Index of the block's first reading in the whole file.
+		ReadingsBlockHeader header;
+	};
+
+	FileManager file;
+	std::span<const std::byte> contents;
+	std::vector<BlockInfo> blocks;
+	uint32_t block_size = 0;
+	size_t total = 0;
+
+	[[noreturn]] void corrupt(const std::string& reason) const {
+		throw std::runtime_error("Corrupt readings file: " + reason);
+	}
+
+	// Decodes all readings of a block into out, which has room for block_size readings.
+	void decode(const BlockInfo& block, int* out) const {
+		const ReadingsBlockHeader& header = block.header;
+		const std::byte* payload = contents.data() + block.offset;
+		uint64_t mask = header.bit_width == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << header.bit_width) - 1;
+
+		int64_t value = header.first;
+		out[0] = header.first;
+		for (size_t i = 1, bit = 0; i < header.count; ++i, bit += header.bit_width) {
+			uint64_t word = 0;
+			if (header.bit_width > 0) {
+				std::memcpy(&word, payload + bit / 8, sizeof(word));
+			}
+			uint64_t packed = (word >> (bit % 8)) & mask;
+			value += static_cast<int64_t>(packed >> 1) ^ -static_cast<int64_t>(packed & 1);
+			out[i] = static_cast<int>(value);
+		}
+	}
+
+public:
+	explicit ReadingsFileReader(const char* path)
+		: file(path, "rb", { FileMode::Mapped, false }) {
+		contents = file.bytes();
+		file.advise(FileAccess::Sequential);
+
+		ReadingsFileHeader header;
+		if (contents.size() < sizeof(header)) { corrupt("missing file header"); }
+		std::memcpy(&header, contents.data(), sizeof(header));
+		if (std::memcmp(header.magic, ReadingsFileHeader().magic, sizeof(header.magic)) != 0 || header.version != 1) {
+			corrupt("unknown format or version");
+		}
+		if (header.block_size == 0) { corrupt("zero block size"); }
+		block_size = header.block_size;
+
+		for (size_t offset = sizeof(header); offset < contents.size();) {
+			BlockInfo block;
+			if (contents.size() - offset < sizeof(ReadingsBlockHeader)) { corrupt("truncated block header"); }
+			std::memcpy(&block.header, contents.data() + offset, sizeof(ReadingsBlockHeader));
+			offset += sizeof(ReadingsBlockHeader);
+
+			const ReadingsBlockHeader& blockHeader = block.header;
+			size_t needed = (static_cast<size_t>(blockHeader.count - 1) * blockHeader.bit_width + 7) / 8 + READINGS_PAYLOAD_PADDING;
+			if (blockHeader.count == 0 || blockHeader.count > block_size || blockHeader.bit_width > 33 ||
+				(blockHeader.bit_width > 0 && blockHeader.payload_bytes < needed) || contents.size() - offset < blockHeader.payload_bytes) {
+				corrupt("invalid block at offset " + std::to_string(offset - sizeof(ReadingsBlockHeader)));
+			}
+			block.offset = offset;
+			block.first_index = total;
+			blocks.push_back(block);
+
+			total += blockHeader.count;
+			offset += blockHeader.payload_bytes;
+		}
+	}
+
+	size_t size() const {
+		return total;
+	}
+
+	size_t blockCount() const {
+		return blocks.size();
+	}
+
+	// Calls f(value) for every reading in the file, in order.
+	template <typename F>
+	void forEach(F f) const {
+		std::vector<int> decoded(block_size);
+		for (const auto& block : blocks) {
+			decode(block, decoded.data());
+			for (uint32_t i = 0; i < block.header.count; ++i) {
+				f(decoded[i]);
+			}
+		}
+	}
+
+	// Calls f(index, value) for the readings with index in [from, to); other blocks are not decoded.
+	template <typename F>
+	void forEachInRange(size_t from, size_t to, F f) const {
+		std::vector<int> decoded(block_size);
+		auto firstBlock = std::upper_bound(blocks.begin(), blocks.end(), from,
+			[](size_t index, const BlockInfo& block) { return index < block.first_index; });
+		if (firstBlock != blocks.begin()) { --firstBlock; }
+
+		for (auto block = firstBlock; block != blocks.end() && block->first_index < to; ++block) {
+			decode(*block, decoded.data());
+			size_t begin = std::max(from, block->first_index) - block->first_index;
+			size_t end = std::min<size_t>(to - block->first_index, block->header.count);
+			for (size_t i = begin; i < end; ++i) {
+				f(block->first_index + i, decoded[i]);
+			}
+		}
+	}
+
+	// Calls f(index, value) for every reading in [low, high]; blocks whose min/max lie outside are skipped.
+	template <typename F>
+	void forEachInValueRange(int low, int high, F f) const {
+		std::vector<int> decoded(block_size);
+		for (const auto& block : blocks) {
+			if (block.header.max < low || block.header.min > high) { continue; }
+
+			decode(block, decoded.data());
+			for (uint32_t i = 0; i < block.header.count; ++i) {
+				if (decoded[i] >= low && decoded[i] <= high) {
+					f(block.first_index + i, decoded[i]);
+				}
+			}
+		}
+	}
+
+	// Number of readings in [low, high]. Blocks entirely inside or outside the range are answered from their headers.
+	size_t countInValueRange(int low, int high) const {
+		size_t count = 0;
+		std::vector<int> decoded(block_size);
+		for (const auto& block : blocks) {
+			if (block.header.max < low || block.header.min > high) { continue; }
+			if (block.header.min >= low && block.header.max <= high) {
+				count += block.header.count;
+				continue;
+			}
+
+			decode(block, decoded.data());
+			count += std::count_if(decoded.begin(), decoded.begin() + block.header.count,
+				[low, high](int value) { return value >= low && value <= high; });
+		}
+		return count;
+	}
+
+	std::vector<int> readAll() const {
+		std::vector<int> values;
+		values.reserve(total);
+		forEach([&values](int value) { values.push_back(value); });
+		return values;
+	}
+};
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "streaming_stats.h"
+
+// Where a Sensor keeps its readings. Implementations decide how much history is retained.
+class IReadingsStore
+{
+public:
+	using Clock = std::chrono::system_clock;
+
+	virtual ~IReadingsStore() = default;
+
+	// Adds a reading taken at the given time. Safe to call from several threads.
+	virtual void append(int value, Clock::time_point time) = 0;
+	// Number of readings currently retained.
+	virtual size_t size() const = 0;
+	// Calls f for every retained reading, oldest first.
+	virtual void forEach(const std::function<void(int)>& f) const = 0;
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// Running statistics over every reading ever appended, queryable while readings stream in.
+	virtual StatsSnapshot stats() const = 0;
+	// Estimated quantile q (0..1) of every reading ever appended.
+	virtual double quantile(double q) const = 0;
+};
+
+// Append-only storage for sensor readings that any number of threads can append to and read concurrently.
+// Readings live in segments of doubling size that are never reallocated, so a reading never moves once
+// written; readers see a published prefix of the readings and iterate it without taking a lock.
+// A writer claims a slot, fills it and marks it written (release). Readers move the published size over the
+// written slots they find (acquire), at the price of scanning the flags of the readings appended since the
+// last size(). Each writer thread also has its own statistics shard: it buffers its readings there without a
+// lock and folds every STATISTICS_BATCH of them into the shard's StreamingStats under a lock that only
+// queries contend for. Appends therefore share no cache line but the slot counter; the statistics cost about
+// 65 ns per reading, most of it in the t-digest (see the append benchmark).
+class ReadingsStore : public IReadingsStore
+{
+private:
+	static constexpr size_t FIRST_SEGMENT_BITS = 10;                    // The first segment holds 1024 readings.
+	static constexpr size_t FIRST_SEGMENT_SIZE = size_t(1) << FIRST_SEGMENT_BITS;
+	static constexpr size_t MAX_SEGMENTS = 64 - FIRST_SEGMENT_BITS - 1; // Enough for any 64-bit index.
+	static constexpr size_t STATISTICS_BATCH = 64;
+	static constexpr double EWMA_NEGLIGIBLE_WEIGHT = 1e-9; // Readings older than this weight are left out of the EWMA.
+
+	struct Segment {
+		std::unique_ptr<int[]> values;
+		std::unique_ptr<std::atomic<uint8_t>[]> ready; // Set once the reading in the same slot is written.
+
+		explicit Segment(size_t size) : values(new int[size]), ready(new std::atomic<uint8_t>[size]()) {}
+	};
+
+	std::atomic<Segment*> segments[MAX_SEGMENTS] = {};
+	std::atomic<size_t> reserved{ 0 };  // Slots handed out to writers.
+	mutable std::atomic<size_t> published{ 0 }; // Slots written and visible to readers; always a prefix of `reserved`.
+
+	// The statistics of one writer thread. Only the writer adds to `pending` and `pending_count`; a query reads
+	// the first pending_count readings, so the writer takes `mutex` only to fold a full batch and empty it.
+	struct alignas(64) StatisticsShard {
+		std::mutex mutex;
+		StreamingStats statistics;
+		std::atomic<size_t> pending_count{ 0 };
+		int pending[STATISTICS_BATCH];
+	};
+
+	const uint64_t store_id = nextStoreId(); // Never reused, unlike the address, so threads can cache their shard by it.
+	mutable std::mutex shards_mutex;
+	std::vector<std::pair<std::thread::id, std::unique_ptr<StatisticsShard>>> statistics_shards;
+
+	// Segment k holds FIRST_SEGMENT_SIZE << k readings, starting at index FIRST_SEGMENT_SIZE * (2^k - 1).
+	static size_t segmentOf(size_t index) {
+		return std::bit_width(index + FIRST_SEGMENT_SIZE) - 1 - FIRST_SEGMENT_BITS;
+	}
+	static size_t offsetIn(size_t index, size_t segment) {
+		return index + FIRST_SEGMENT_SIZE - (FIRST_SEGMENT_SIZE << segment);
+	}
+
+	// Stands in segments[k] while one writer allocates segment k; segments double in size, so racing writers
+	// must not each allocate (and zero) a copy.
+	static Segment* allocatingMarker() {
+		static Segment marker(0);
+		return &marker;
+	}
+
+	// Returns the segment, allocating it if no other writer has yet. Writers that find it being allocated
+	// wait for the pointer.
+	Segment* segment(size_t k) {
+		Segment* existing = segments[k].load(std::memory_order_acquire);
+		if (existing && existing != allocatingMarker()) { return existing; }
+
+		if (!existing && segments[k].compare_exchange_strong(existing, allocatingMarker(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+			Segment* allocated = nullptr;
+			try {
+				allocated = new Segment(FIRST_SEGMENT_SIZE << k);
+			}
+			catch (...) {
+				segments[k].store(nullptr, std::memory_order_release);
+				segments[k].notify_all();
+				throw;
+			}
+			segments[k].store(allocated, std::memory_order_release);
+			segments[k].notify_all();
+			return allocated;
+		}
+		while ((existing = segments[k].load(std::memory_order_acquire)) == allocatingMarker()) {
+			segments[k].wait(allocatingMarker(), std::memory_order_acquire);
+		}
+		// The allocating writer failed; try again.
+		return existing ? existing : segment(k);
+	}
+
+	bool isReady(size_t index) const {
+		size_t k = segmentOf(index);
+		const Segment* data = segments[k].load(std::memory_order_acquire);
+		return data && data != allocatingMarker() && data->ready[offsetIn(index, k)].load(std::memory_order_acquire) != 0;
+	}
+
+	static uint64_t nextStoreId() {
+		static std::atomic<uint64_t> next_id{ 1 };
+		return next_id.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// The calling thread's shard, created on its first append. A small per-thread cache keeps the lookup
+	// lock-free for the stores the thread appends to most recently.
+	StatisticsShard& shardOfThisThread() {
+		static constexpr size_t CACHED_STORES = 8;
+		thread_local std::vector<std::pair<uint64_t, StatisticsShard*>> cache;
+		for (const auto& [id, shard] : cache) {
+			if (id == store_id) { return *shard; }
+		}
+
+		StatisticsShard* shard = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(shards_mutex);
+			std::thread::id thread = std::this_thread::get_id();
+			for (const auto& [owner, existing] : statistics_shards) {
+				if (owner == thread) { shard = existing.get(); }
+			}
+			if (!shard) {
+				statistics_shards.emplace_back(thread, std::make_unique<StatisticsShard>());
+				shard = statistics_shards.back().second.get();
+			}
+		}
+		if (cache.size() == CACHED_STORES) { cache.erase(cache.begin()); }
+		cache.emplace_back(store_id, shard);
+		return *shard;
+	}
+
+	void addToStatistics(int value) {
+		StatisticsShard& shard = shardOfThisThread();
+		size_t count = shard.pending_count.load(std::memory_order_relaxed);
+		shard.pending[count] = value;
+		if (count + 1 < STATISTICS_BATCH) {
+			shard.pending_count.store(count + 1, std::memory_order_release);
+			return;
+		}
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.statistics.add(shard.pending, STATISTICS_BATCH);
+		shard.pending_count.store(0, std::memory_order_relaxed);
+	}
+
+	void mergeShards(StreamingStats& merged) const {
+		std::lock_guard<std::mutex> lock(shards_mutex);
+		for (const auto& [owner, shard] : statistics_shards) {
+			std::lock_guard<std::mutex> shardLock(shard->mutex);
+			merged.merge(shard->statistics);
+			merged.add(shard->pending, shard->pending_count.load(std::memory_order_acquire));
+		}
+	}
+
+	// The shards lose the order of the readings, so the EWMA is recomputed from the newest published ones:
+	// as many as it takes for the weight of every older reading to drop below EWMA_NEGLIGIBLE_WEIGHT.
+	double ewmaOfNewest(double alpha) const {
+		size_t count = size();
+		size_t window = count;
+		if (alpha > 0.0 && alpha < 1.0) {
+			window = std::min(count, static_cast<size_t>(std::ceil(std::log(EWMA_NEGLIGIBLE_WEIGHT) / std::log1p(-alpha))));
+		}
+		else if (alpha >= 1.0) {
+			window = std::min<size_t>(count, 1);
+		}
+		if (window == 0) { return 0.0; }
+
+		double ewma = (*this)[count - window];
+		for (size_t i = count - window + 1; i < count; ++i) {
+			ewma += alpha * ((*this)[i] - ewma);
+		}
+		return ewma;
+	}
+
+public:
+	class const_iterator
+	{
+	private:
+		const ReadingsStore* store;
+		size_t index;
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = int;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const int*;
+		using reference = const int&;
+
+		const_iterator() : store(nullptr), index(0) {}
+		const_iterator(const ReadingsStore* owner, size_t position) : store(owner), index(position) {}
+
+		reference operator*() const { return (*store)[index]; }
+		const_iterator& operator++() { ++index; return *this; }
+		const_iterator operator++(int) { const_iterator previous = *this; ++index; return previous; }
+		bool operator==(const const_iterator& other) const { return index == other.index; }
+	};
+
+	ReadingsStore() = default;
+	~ReadingsStore() {
+		for (auto& segment : segments) {
+			delete segment.load(std::memory_order_relaxed);
+		}
+	}
+
+	ReadingsStore(const ReadingsStore&) = delete;
+	ReadingsStore& operator=(const ReadingsStore&) = delete;
+
+	// Appends a reading. Safe to call from any number of threads; returns the reading's index.
+	size_t append(int value) {
+		size_t index = reserved.fetch_add(1, std::memory_order_relaxed);
+		size_t k = segmentOf(index);
+		Segment* data = segment(k);
+		data->values[offsetIn(index, k)] = value;
+		data->ready[offsetIn(index, k)].store(1, std::memory_order_release);
+		addToStatistics(value);
+		return index;
+	}
+
+	// Keeps every reading; the time is not stored.
+	void append(int value, Clock::time_point) override {
+		append(value);
+	}
+
+	// Number of readings visible to readers. Readings below this index never change.
+	// Moves the published size over the consecutive written slots behind it; a slot claimed by a writer that
+	// has not filled it yet stops the scan, and the readings behind it become visible once it is filled.
+	size_t size() const override {
+		size_t frontier = published.load(std::memory_order_acquire);
+		size_t end = frontier;
+		while (isReady(end)) { ++end; }
+		while (frontier < end && !published.compare_exchange_weak(frontier, end, std::memory_order_acq_rel, std::memory_order_acquire)) {}
+		return std::max(frontier, end);
+	}
+
+	// Merges the per-thread statistics: O(writer threads x t-digest centroids) per query, whatever the number of readings.
+	StatsSnapshot stats() const override {
+		StreamingStats merged;
+		mergeShards(merged);
+		StatsSnapshot result = merged.snapshot();
+		if (result.count > 0) { result.ewma = ewmaOfNewest(merged.ewmaAlpha()); }
+		return result;
+	}
+
+	double quantile(double q) const override {
+		StreamingStats merged;
+		mergeShards(merged);
+		return merged.quantile(q);
+	}
+
+	// Reading at an index below size().
+	const int& operator[](size_t index) const {
+		size_t k = segmentOf(index);
+		return segments[k].load(std::memory_order_acquire)->values[offsetIn(index, k)];
+	}
+
+	// Iterates over the readings published when begin()/end() are called; later appends do not affect the range.
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, size()); }
+
+	// Calls f for every reading published at the time of the call, a whole segment at a time.
+	void forEach(const std::function<void(int)>& f) const override {
+		size_t count = size();
+		for (size_t k = 0, start = 0; start < count; start += FIRST_SEGMENT_SIZE << k, ++k) {
+			const int* data = segments[k].load(std::memory_order_acquire)->values.get();
+			size_t length = std::min(count - start, FIRST_SEGMENT_SIZE << k);
+			for (size_t i = 0; i < length; ++i) {
+				f(data[i]);
+			}
+		}
+	}
+};
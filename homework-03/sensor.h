@@ -0,0 +1,84 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include "readings_file.h"
+#include "readings_store.h"
+
+class Sensor
+{
+private:
+	std::shared_ptr<IReadingsStore> readings;
+	std::string sensor_name;
+public:
+	Sensor(const std::string& name, std::shared_ptr<IReadingsStore> shared_readings = nullptr)
+		: sensor_name(name) {
+		if (shared_readings) {
+			readings = shared_readings;
+		}
+		else {
+			readings = std::make_shared<ReadingsStore>();
+		}
+		std::cout << "Sensor '" << sensor_name << "' created. Readings are shared (" << readings.use_count() << " owner" << (readings.use_count() > 1 ? "s" : "") << ")." << std::endl;
+	}
+
+	// Safe to call concurrently, also from several sensors sharing the same readings.
+	void addReading(int value) {
+		addReading(value, IReadingsStore::Clock::now());
+	}
+
+	// Adds a reading taken at the given time, e.g. when replaying recorded data.
+	void addReading(int value, IReadingsStore::Clock::time_point time) {
+		if (readings) {
+			readings->append(value, time);
+			std::cout << "Sensor '" << sensor_name << "': Added readings " << value << "." << std::endl;
+		}
+		else {
+			std::cerr << "Sensor '" << sensor_name << "': There is no valid store to add readings to." << std::endl;
+		}
+	}
+
+	void printReadings() const {
+		if (readings && !readings->empty()) {
+			std::cout << "Sensor '" << sensor_name << "' readings (" << readings.use_count() << " owners): [";
+			const char* separator = "";
+			readings->forEach([&separator](int value) {
+				std::cout << separator << value;
+				separator = ", ";
+			});
+			std::cout << "]" << std::endl;
+		}
+		else {
+			std::cout << "Sensor '" << sensor_name << "': No readings." << std::endl;
+		}
+	}
+
+	void printStatistics() const {
+		StatsSnapshot stats = readings ? readings->stats() : StatsSnapshot();
+		if (stats.count == 0) {
+			std::cout << "Sensor '" << sensor_name << "': No statistics yet." << std::endl;
+			return;
+		}
+		std::cout << "Sensor '" << sensor_name << "' statistics: count " << stats.count << ", min " << stats.min << ", max " << stats.max
+				  << ", mean " << stats.mean << ", stddev " << stats.stddev << ", EWMA " << stats.ewma
+				  << ", p50 " << stats.p50 << ", p90 " << stats.p90 << ", p99 " << stats.p99 << std::endl;
+	}
+
+	// Writes the retained readings to a binary readings file (see readings_file.h).
+	void saveReadings(const std::string& path) const {
+		if (!readings) {
+			std::cerr << "Sensor '" << sensor_name << "': There are no readings to save." << std::endl;
+			return;
+		}
+		ReadingsFileWriter writer(path.c_str());
+		readings->forEach([&writer](int value) { writer.append(value); });
+		writer.close();
+		std::cout << "Sensor '" << sensor_name << "': Saved " << writer.size() << " readings to '" << path << "'." << std::endl;
+	}
+
+	const auto get_name()
+	{
+		return sensor_name;
+	}
+};
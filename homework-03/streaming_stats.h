@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <numbers>
+#include <vector>
+
+// Point-in-time copy of the statistics collected by StreamingStats.
+struct StatsSnapshot {
+	size_t count = 0;
+	int min = 0;
+	int max = 0;
+	double mean = 0.0;
+	double variance = 0.0; // Sample variance (n - 1 in the denominator).
+	double stddev = 0.0;
+	double ewma = 0.0;     // Exponentially weighted moving average.
+	double p50 = 0.0;      // Approximate quantiles from the t-digest.
+	double p90 = 0.0;
+	double p99 = 0.0;
+};
+
+// Merging t-digest: a compact sketch of a distribution from which quantiles can be estimated.
+// New points are buffered and merged into a bounded number of centroids; centroids near the tails stay
+// small, so extreme quantiles such as p99 stay accurate.
+class TDigest
+{
+private:
+	struct Centroid {
+		double mean;
+		double weight;
+	};
+
+	double compression;
+	std::vector<Centroid> centroids;
+	std::vector<Centroid> buffer;
+	std::vector<Centroid> merged; // Scratch space reused by every merge.
+	double total_weight = 0.0; // Weight of the centroids and the buffered points together.
+	double min_value = std::numeric_limits<double>::infinity();
+	double max_value = -std::numeric_limits<double>::infinity();
+
+	// Scale function k1: maps a quantile to an index so that centroids get smaller towards both tails.
+	double scale(double q) const {
+		return compression / (2.0 * std::numbers::pi) * std::asin(2.0 * q - 1.0);
+	}
+	double inverseScale(double k) const {
+		return (std::sin(k * 2.0 * std::numbers::pi / compression) + 1.0) / 2.0;
+	}
+
+	void addCentroid(const Centroid& centroid) {
+		buffer.push_back(centroid);
+		total_weight += centroid.weight;
+		if (buffer.size() >= static_cast<size_t>(5 * compression)) { merge(); }
+	}
+
+	void merge() {
+		if (buffer.empty()) { return; }
+
+		// Only the new points need sorting; the centroids are already in order.
+		auto byMean = [](const Centroid& left, const Centroid& right) { return left.mean < right.mean; };
+		std::sort(buffer.begin(), buffer.end(), byMean);
+		merged.clear();
+		std::merge(centroids.begin(), centroids.end(), buffer.begin(), buffer.end(), std::back_inserter(merged), byMean);
+		centroids.clear();
+
+		double weightSoFar = 0.0;
+		double limit = total_weight * inverseScale(scale(0.0) + 1.0);
+		Centroid current = merged.front();
+		for (size_t i = 1; i < merged.size(); ++i) {
+			const Centroid& next = merged[i];
+			if (weightSoFar + current.weight + next.weight <= limit) {
+				current.weight += next.weight;
+				current.mean += (next.mean - current.mean) * next.weight / current.weight;
+			}
+			else {
+				weightSoFar += current.weight;
+				centroids.push_back(current);
+				limit = total_weight * inverseScale(scale(weightSoFar / total_weight) + 1.0);
+				current = next;
+			}
+		}
+		centroids.push_back(current);
+		buffer.clear();
+	}
+
+public:
+	explicit TDigest(double compressionFactor = 100.0) : compression(compressionFactor) {
+		buffer.reserve(static_cast<size_t>(5 * compression));
+	}
+
+	void add(double value) {
+		addCentroid({ value, 1.0 });
+		min_value = std::min(min_value, value);
+		max_value = std::max(max_value, value);
+	}
+
+	// Adds the points summarized by another digest, taking each of its centroids as one weighted point.
+	void add(const TDigest& other) {
+		for (const Centroid& centroid : other.centroids) { addCentroid(centroid); }
+		for (const Centroid& centroid : other.buffer) { addCentroid(centroid); }
+		min_value = std::min(min_value, other.min_value);
+		max_value = std::max(max_value, other.max_value);
+	}
+
+	// Estimated value below which a fraction q (0..1) of the points lie. NaN if nothing was added.
+	double quantile(double q) {
+		merge();
+		if (centroids.empty()) { return std::numeric_limits<double>::quiet_NaN(); }
+		if (centroids.size() == 1) { return centroids.front().mean; }
+
+		q = std::clamp(q, 0.0, 1.0);
+		double index = q * total_weight;
+		// Each centroid is treated as centred on its cumulative weight; interpolates between neighbouring centres,
+		// and between the outer centres and the exact minimum and maximum.
+		double firstCenter = centroids.front().weight / 2.0;
+		if (index < firstCenter) {
+			return min_value + (centroids.front().mean - min_value) * index / firstCenter;
+		}
+
+		double cumulative = 0.0;
+		for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+			double center = cumulative + centroids[i].weight / 2.0;
+			double nextCenter = cumulative + centroids[i].weight + centroids[i + 1].weight / 2.0;
+			if (index <= nextCenter) {
+				double fraction = (index - center) / (nextCenter - center);
+				return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * fraction;
+			}
+			cumulative += centroids[i].weight;
+		}
+
+		double lastCenter = total_weight - centroids.back().weight / 2.0;
+		double fraction = (index - lastCenter) / (total_weight - lastCenter);
+		return centroids.back().mean + (max_value - centroids.back().mean) * fraction;
+	}
+
+	size_t centroidCount() {
+		merge();
+		return centroids.size();
+	}
+};
+
+// Running statistics over a stream of readings, updated in O(1) amortized time per reading:
+// count, min, max, mean and variance (Welford's algorithm), an EWMA and t-digest quantiles.
+// A short critical section per update keeps it safe to query while other threads add readings.
+// Instances can be merged, so that several writers can each update their own and queries combine them.
+class StreamingStats
+{
+private:
+	mutable std::mutex stats_mutex;
+	size_t count = 0;
+	int min = 0;
+	int max = 0;
+	double mean = 0.0;
+	double m2 = 0.0;        // Sum of squared differences from the mean (Welford).
+	double ewma_alpha;
+	double ewma = 0.0;
+	mutable TDigest digest; // Merges its buffer lazily, also when queried.
+
+	void addLocked(int value) {
+		++count;
+		if (count == 1) {
+			min = max = value;
+			ewma = value;
+		}
+		else {
+			min = std::min(min, value);
+			max = std::max(max, value);
+			ewma += ewma_alpha * (value - ewma);
+		}
+		double delta = value - mean;
+		mean += delta / count;
+		m2 += delta * (value - mean);
+		digest.add(value);
+	}
+
+public:
+	explicit StreamingStats(double ewmaAlpha = 0.1, double compression = 100.0)
+		: ewma_alpha(ewmaAlpha), digest(compression) {}
+
+	StreamingStats(const StreamingStats&) = delete;
+	StreamingStats& operator=(const StreamingStats&) = delete;
+
+	void add(int value) {
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		addLocked(value);
+	}
+
+	// Adds a batch of readings under one lock.
+	void add(const int* values, size_t valueCount) {
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		for (size_t i = 0; i < valueCount; ++i) {
+			addLocked(values[i]);
+		}
+	}
+
+	// Adds the readings summarized by other (Chan et al.'s pairwise update of the mean and variance).
+	// The EWMA stays this one's, or becomes other's if this one is empty: it depends on the order of the
+	// readings, which the summaries do not keep.
+	void merge(const StreamingStats& other) {
+		if (&other == this) { return; }
+		std::scoped_lock lock(stats_mutex, other.stats_mutex);
+		if (other.count == 0) { return; }
+		if (count == 0) {
+			min = other.min;
+			max = other.max;
+			ewma = other.ewma;
+		}
+		else {
+			min = std::min(min, other.min);
+			max = std::max(max, other.max);
+		}
+		size_t total = count + other.count;
+		double delta = other.mean - mean;
+		mean += delta * other.count / total;
+		m2 += other.m2 + delta * delta * count * other.count / total;
+		count = total;
+		digest.add(other.digest);
+	}
+
+	double ewmaAlpha() const { return ewma_alpha; }
+
+	// Estimated quantile q (0..1) of all readings added so far.
+	double quantile(double q) const {
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		return digest.quantile(q);
+	}
+
+	StatsSnapshot snapshot() const {
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		StatsSnapshot result;
+		result.count = count;
+		if (count == 0) { return result; }
+
+		result.min = min;
+		result.max = max;
+		result.mean = mean;
+		result.variance = count > 1 ? m2 / (count - 1) : 0.0;
+		result.stddev = std::sqrt(result.variance);
+		result.ewma = ewma;
+		result.p50 = digest.quantile(0.50);
+		result.p90 = digest.quantile(0.90);
+		result.p99 = digest.quantile(0.99);
+		return result;
+	}
+};
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "coro_task.h"
+#include "parallel_math.h"
+#include "task_graph.h"
+#include "thread_pool.h"
+
+using Clock = std::chrono::steady_clock;
+
+// A bulk job: counts primes by trial division, like simpleNum, for about a hundred microseconds.
+size_t countPrimes(size_t from, size_t to) {
+	size_t count = 0;
+	for (size_t i = std::max<size_t>(from, 2); i < to; ++i) {
+		bool prime = true;
+		for (size_t j = 2; j * j <= i; ++j) {
+			if (i % j == 0) { prime = false; break; }
+		}
+		count += prime;
+	}
+	return count;
+}
+
+void printStats(const std::string& label, const LatencyStats& stats) {
+	std::cout << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+		<< "p50 " << std::setw(9) << stats.p50_us << " us   p99 " << std::setw(9) << stats.p99_us
+		<< " us   max " << std::setw(9) << stats.max_us << " us   (" << stats.count << " tasks)" << std::endl;
+}
+
+// Keeps the pool saturated with low priority bulk jobs while a probe task is added every millisecond.
+// Returns the time from adding each probe to its start.
+LatencyStats measureProbes(TaskPriority probePriority, std::chrono::milliseconds duration) {
+	SimpleThreadPool pool(std::max(2u, std::thread::hardware_concurrency()), false);
+	LatencyHistogram probeLatency;
+	std::atomic<size_t> outstanding{ 0 };
+	std::atomic<size_t> primes{ 0 };
+	const size_t backlog = 64 * pool.threadCount(); // Bulk jobs kept waiting, a few milliseconds of work per worker.
+
+	auto end = Clock::now() + duration;
+	std::thread producer([&] {
+		size_t block = 0;
+		while (Clock::now() < end) {
+			while (outstanding.load() < backlog) {
+				++outstanding;
+				size_t from = (block++ % 64) * 4000;
+				pool.addTask(TaskOptions{ .priority = TaskPriority::Low }, [&](size_t start) {
+					primes += countPrimes(start, start + 4000);
+					--outstanding;
+				}, "bulk", from);
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Lets the backlog build up.
+	while (Clock::now() < end) {
+		pool.addTask(TaskOptions{ .priority = probePriority }, [&probeLatency](Clock::time_point added) {
+			probeLatency.record(Clock::now() - added);
+		}, "probe", Clock::now());
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	producer.join();
+	pool.waitIdle();
+	return probeLatency.stats();
+}
+
+// How late delayed tasks start compared with the time they were due.
+LatencyStats measureTimerLateness(size_t tasks) {
+	SimpleThreadPool pool(2, false);
+	LatencyHistogram lateness;
+	for (size_t i = 0; i < tasks; ++i) {
+		auto delay = std::chrono::milliseconds(1 + i % 50);
+		pool.addTask(TaskOptions{ .delay = delay }, [&lateness](Clock::time_point due) {
+			lateness.record(Clock::now() - due);
+		}, "delayed", Clock::now() + delay);
+	}
+	pool.waitIdle();
+	return lateness.stats();
+}
+
+// Time to run many empty tasks: one thread per task, as the original SimpleThreadPool did, against the pool.
+void measureOverhead(size_t tasks) {
+	std::atomic<size_t> done{ 0 };
+	auto start = Clock::now();
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(tasks);
+		for (size_t i = 0; i < tasks; ++i) {
+			threads.emplace_back([&done] { ++done; });
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+	double threadPerTask = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / tasks;
+
+	start = Clock::now();
+	{
+		SimpleThreadPool pool(std::max(2u, std::thread::hardware_concurrency()), false);
+		for (size_t i = 0; i < tasks; ++i) {
+			pool.addTask([&done] { ++done; }, "empty");
+		}
+	}
+	double pooled = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / tasks;
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Thread per task: " << threadPerTask << " us/task, pool: " << pooled << " us/task (" << done << " tasks run)" << std::endl;
+}
+
+// Many independent four-stage flows, like the order flow: one thread per stage that joins the thread of the
+// previous stage, against a TaskGraph on a pool.
+void measureDependencyChains(size_t flows) {
+	const size_t stages = 4;
+	std::atomic<size_t> primes{ 0 };
+	auto stage = [&primes](size_t flow) { primes += countPrimes(flow * 100, flow * 100 + 500); };
+
+	auto start = Clock::now();
+	{
+		std::vector<std::thread> threads(flows * stages);
+		for (size_t flow = 0; flow < flows; ++flow) {
+			for (size_t s = 0; s < stages; ++s) {
+				std::thread* previous = s > 0 ? &threads[flow * stages + s - 1] : nullptr;
+				threads[flow * stages + s] = std::thread([&stage, previous, flow] {
+					if (previous) { previous->join(); }
+					stage(flow);
+				});
+			}
+		}
+		for (size_t flow = 0; flow < flows; ++flow) {
+			threads[flow * stages + stages - 1].join();
+		}
+	}
+	double joinChains = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	TaskGraph graph;
+	for (size_t flow = 0; flow < flows; ++flow) {
+		auto previous = graph.add("stage", [&stage, flow] { stage(flow); return flow; });
+		for (size_t s = 1; s < stages; ++s) {
+			previous = graph.add("stage", [&stage](size_t f) { stage(f); return f; }, previous);
+		}
+	}
+	SimpleThreadPool pool(std::max(2u, std::thread::hardware_concurrency()), false);
+	start = Clock::now();
+	graph.run(pool);
+	double taskGraph = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(1) << flows << " flows x " << stages << " stages: join chains "
+		<< joinChains << " ms (" << flows * stages << " threads), task graph " << taskGraph << " ms ("
+		<< pool.threadCount() << " threads, " << primes << " primes)" << std::endl;
+}
+
+// One task fanning out to many independent ones and a final task joining them, with the timing report.
+void measureFanOut(size_t width, const std::filesystem::path& tracePath) {
+	TaskGraph graph;
+	auto range = graph.add("split", [] { return size_t{ 200000 }; });
+	std::vector<TaskRef<size_t>> parts;
+	for (size_t i = 0; i < width; ++i) {
+		parts.push_back(graph.add("count " + std::to_string(i), [i, width](size_t limit) {
+			return countPrimes(limit * i / width, limit * (i + 1) / width);
+		}, range));
+	}
+	auto total = graph.add("sum", [&parts] {
+		size_t sum = 0;
+		for (const auto& part : parts) { sum += part.get(); }
+		return sum;
+	});
+	for (const auto& part : parts) { graph.precede(part, total); }
+
+	SimpleThreadPool pool(std::max(2u, std::thread::hardware_concurrency()), false);
+	pool.startTrace();
+	graph.run(pool);
+	graph.printTimings(std::cout);
+	std::cout << "Primes below 200000: " << total.get() << "\n" << std::endl;
+
+	// run() returns once the results are set; the workers record the last tasks' metrics after that.
+	pool.waitIdle();
+	pool.printMetrics(std::cout);
+	std::ofstream trace(tracePath);
+	pool.writeChromeTrace(trace);
+	std::cout << "Trace written to " << tracePath.string() << " (open it in chrome://tracing or ui.perfetto.dev)" << std::endl;
+}
+
+// Cost of recording one task run in PoolMetrics, without and with a trace.
+void measureInstrumentation(size_t records) {
+	const std::string names[] = { "validate", "price", "check inventory", "invoice" };
+	PoolMetrics metrics(1);
+	auto runCase = [&](const char* label) {
+		auto start = Clock::now();
+		for (size_t i = 0; i < records; ++i) {
+			Clock::time_point now = Clock::now();
+			metrics.record(0, names[i % 4], now - std::chrono::microseconds(i % 100), now, now + std::chrono::microseconds(i % 10));
+		}
+		double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / records;
+		std::cout << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+			<< ns << " ns per task (including one clock read)" << std::endl;
+	};
+	runCase("Metrics");
+	metrics.startTrace(records);
+	runCase("Metrics and trace spans");
+}
+
+// One order stage: a little computation, like validating or pricing an order.
+size_t orderStage(size_t order) {
+	return countPrimes(order % 64 * 100, order % 64 * 100 + 300);
+}
+
+CoroTask<size_t> processOrderAsync(SimpleThreadPool& pool, size_t order, std::chrono::milliseconds warehouseDelay) {
+	co_await scheduleOn(pool);
+	size_t result = orderStage(order);
+	result += orderStage(order + 1);
+	co_await scheduleAfter(pool, warehouseDelay); // Waits for the warehouse without holding a thread.
+	result += orderStage(order + 2);
+	co_await scheduleOn(pool);
+	result += orderStage(order + 3);
+	co_return result;
+}
+
+// Many orders in flight at once, each going through four stages, the third of which waits for a reply from
+// the warehouse: one thread per stage joining the previous one, as the original order flow did, against
+// one coroutine per order on a pool.
+void measureInFlightOrders(size_t orders, std::chrono::milliseconds warehouseDelay) {
+	const size_t stages = 4;
+	std::atomic<size_t> threadTotal{ 0 };
+	auto start = Clock::now();
+	{
+		std::vector<std::thread> threads(orders * stages);
+		for (size_t order = 0; order < orders; ++order) {
+			for (size_t s = 0; s < stages; ++s) {
+				std::thread* previous = s > 0 ? &threads[order * stages + s - 1] : nullptr;
+				threads[order * stages + s] = std::thread([&threadTotal, previous, order, s, warehouseDelay] {
+					if (previous) { previous->join(); }
+					if (s == 2) { std::this_thread::sleep_for(warehouseDelay); }
+					threadTotal += orderStage(order + s);
+				});
+			}
+		}
+		for (size_t order = 0; order < orders; ++order) {
+			threads[order * stages + stages - 1].join();
+		}
+	}
+	double threadPerStage = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	SimpleThreadPool pool(std::max(2u, std::thread::hardware_concurrency()), false);
+	start = Clock::now();
+	std::vector<CoroTask<size_t>> flows;
+	flows.reserve(orders);
+	for (size_t order = 0; order < orders; ++order) {
+		flows.push_back(processOrderAsync(pool, order, warehouseDelay));
+	}
+	size_t coroutineTotal = 0;
+	for (size_t result : syncWait(whenAll(std::move(flows)))) {
+		coroutineTotal += result;
+	}
+	double coroutines = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(1) << orders << " orders: thread per stage " << threadPerStage << " ms ("
+		<< orders * stages << " threads), coroutines " << coroutines << " ms (" << pool.threadCount() << " threads)"
+		<< (threadTotal == coroutineTotal ? "" : ", RESULTS DIFFER") << std::endl;
+}
+
+// Runs the computation on pools of 1, 2, 4, ... threads and draws the speedup over one thread as a bar chart.
+// The computation is started from a task of the pool, so exactly `threads` threads work on it.
+template <typename Compute>
+void printScalingChart(const std::string& label, Compute compute) {
+	size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+	std::cout << label << " (" << std::thread::hardware_concurrency() << " hardware threads)\n" << std::endl;
+	std::cout << "Threads      Time   Speedup" << std::endl;
+
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	double baseline = 0.0;
+	std::string firstResult;
+	for (size_t threads : threadCounts) {
+		SimpleThreadPool pool(threads, false);
+		std::string result;
+		auto start = Clock::now();
+		pool.addTask([&] { result = compute(pool); }, "compute");
+		pool.waitIdle();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (threads == 1) {
+			baseline = ms;
+			firstResult = result;
+		}
+
+		double speedup = baseline / ms;
+		std::cout << std::setw(7) << threads << std::fixed << std::setprecision(1) << std::setw(10) << ms << " ms"
+			<< std::setprecision(2) << std::setw(7) << speedup << "x  " << std::string(static_cast<size_t>(speedup * 10.0 + 0.5), '#')
+			<< (result == firstResult ? "" : "  RESULT DIFFERS: " + result) << std::endl;
+	}
+	std::cout << "Result: " << firstResult << "\n" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	auto duration = std::chrono::milliseconds(argc > 1 ? std::stoll(argv[1]) : 2000);
+	uint64_t limit = argc > 2 ? std::stoull(argv[2]) : 1000000000;
+	std::filesystem::path tracePath = argc > 3 ? std::filesystem::path(argv[3]) : std::filesystem::temp_directory_path() / "task_graph_trace.json";
+
+	std::cout << "------ Probe latency under a saturating low priority load (" << duration.count() << " ms each) ------\n" << std::endl;
+	printStats("Probes with the same priority as the load", measureProbes(TaskPriority::Low, duration));
+	printStats("Probes with high priority", measureProbes(TaskPriority::High, duration));
+
+	std::cout << "\n------ Timer wheel: lateness of delayed tasks (1-50 ms) ------\n" << std::endl;
+	printStats("Delayed tasks", measureTimerLateness(2000));
+
+	std::cout << "\n------ Overhead per task ------\n" << std::endl;
+	measureOverhead(20000);
+
+	std::cout << "\n------ Dependent stages: join chains against a task graph ------\n" << std::endl;
+	measureDependencyChains(1000);
+
+	std::cout << "\n------ Fan-out and fan-in ------\n" << std::endl;
+	measureFanOut(8, tracePath);
+
+	std::cout << "\n------ Instrumentation cost ------\n" << std::endl;
+	measureInstrumentation(2000000);
+
+	std::cout << "\n------ Data-parallel math: parallelReduce scaling ------\n" << std::endl;
+	printScalingChart("Primes up to " + std::to_string(limit) + ", segmented sieve", [limit](SimpleThreadPool& pool) {
+		return std::to_string(countPrimesUpTo(pool, limit));
+	});
+	printScalingChart("Sum of squares from 1 to " + std::to_string(limit) + ", 128-bit", [limit](SimpleThreadPool& pool) {
+		return sumOfSquares(pool, 1, limit).toString();
+	});
+	std::cout << "\n------ Orders in flight: thread per stage against coroutines (5 ms warehouse reply) ------\n" << std::endl;
+	for (size_t orders : { 100, 1000, 2000 }) {
+		measureInFlightOrders(orders, std::chrono::milliseconds(5));
+	}
+
+	return 0;
+}
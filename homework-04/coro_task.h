@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+template <typename T>
+class CoroTask;
+
+// State shared by the promises of all CoroTasks: the coroutine to resume when the task finishes, and the
+// exception it finished with, if any.
+class CoroTaskPromiseBase
+{
+private:
+	struct FinalAwaiter {
+		bool await_ready() const noexcept { return false; }
+
+		// Resumes the awaiting coroutine directly instead of returning to the thread that resumed this one.
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+			return finished.promise().continuation;
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+protected:
+	std::exception_ptr error;
+
+public:
+	std::coroutine_handle<> continuation = std::noop_coroutine();
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	FinalAwaiter final_suspend() const noexcept { return {}; }
+	void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+class CoroTaskPromise : public CoroTaskPromiseBase
+{
+private:
+	std::optional<T> value;
+
+public:
+	CoroTask<T> get_return_object();
+
+	template <typename U>
+	void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+	T result() {
+		if (error) { std::rethrow_exception(error); }
+		return std::move(*value);
+	}
+};
+
+template <>
+class CoroTaskPromise<void> : public CoroTaskPromiseBase
+{
+public:
+	CoroTask<void> get_return_object();
+
+	void return_void() const noexcept {}
+
+	void result() {
+		if (error) { std::rethrow_exception(error); }
+	}
+};
+
+// A lazily started coroutine producing a T. It starts when awaited, and the awaiting coroutine continues on
+// whichever thread the task finishes on. Every CoroTask must be awaited (or passed to whenAll or syncWait)
+// exactly once, and must not be destroyed while it is running.
+template <typename T = void>
+class CoroTask
+{
+private:
+	std::coroutine_handle<CoroTaskPromise<T>> handle;
+
+	// Starts the task and resumes the awaiting coroutine when it finishes, without taking the result.
+	struct CompletionAwaiter {
+		std::coroutine_handle<CoroTaskPromise<T>> handle;
+
+		bool await_ready() const noexcept { return false; }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+			handle.promise().continuation = awaiting;
+			return handle;
+		}
+		void await_resume() const noexcept {}
+	};
+
+public:
+	using promise_type = CoroTaskPromise<T>;
+
+	explicit CoroTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	CoroTask(CoroTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	CoroTask& operator=(CoroTask&& other) noexcept {
+		if (this != &other) {
+			if (handle) { handle.destroy(); }
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+	CoroTask(const CoroTask&) = delete;
+	CoroTask& operator=(const CoroTask&) = delete;
+
+	~CoroTask() {
+		if (handle) { handle.destroy(); }
+	}
+
+	bool await_ready() const noexcept { return false; }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+		handle.promise().continuation = awaiting;
+		return handle;
+	}
+	T await_resume() { return handle.promise().result(); }
+
+	// co_await task.completion() waits for the task without taking its result; result() then returns it.
+	CompletionAwaiter completion() const noexcept { return { handle }; }
+
+	// The result of a finished task. Rethrows the exception the task finished with.
+	T result() { return handle.promise().result(); }
+};
+
+template <typename T>
+CoroTask<T> CoroTaskPromise<T>::get_return_object() {
+	return CoroTask<T>(std::coroutine_handle<CoroTaskPromise<T>>::from_promise(*this));
+}
+
+inline CoroTask<void> CoroTaskPromise<void>::get_return_object() {
+	return CoroTask<void>(std::coroutine_handle<CoroTaskPromise<void>>::from_promise(*this));
+}
+
+// co_await scheduleOn(pool) suspends the coroutine and resumes it on a worker of the pool. With a delay, the
+// coroutine waits in the pool's timer instead of blocking a thread.
+class ScheduleOnPool
+{
+private:
+	SimpleThreadPool& pool;
+	TaskPriority priority;
+	std::chrono::steady_clock::duration delay;
+
+public:
+	ScheduleOnPool(SimpleThreadPool& pool, TaskPriority priority, std::chrono::steady_clock::duration delay)
+		: pool(pool), priority(priority), delay(delay) {}
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) {
+		pool.addTask(TaskOptions{ .priority = priority, .delay = delay }, [handle] { handle.resume(); }, "coroutine");
+	}
+	void await_resume() const noexcept {}
+};
+
+inline ScheduleOnPool scheduleOn(SimpleThreadPool& pool, TaskPriority priority = TaskPriority::Normal) {
+	return ScheduleOnPool(pool, priority, std::chrono::steady_clock::duration::zero());
+}
+
+inline ScheduleOnPool scheduleAfter(SimpleThreadPool& pool, std::chrono::steady_clock::duration delay,
+	TaskPriority priority = TaskPriority::Normal) {
+	return ScheduleOnPool(pool, priority, delay);
+}
+
+// A coroutine that awaits one CoroTask and then tells its Signal, whose finished() returns the coroutine to
+// resume next. whenAll and syncWait use it to learn when tasks finish.
+template <typename Signal>
+class CoroTaskRunner
+{
+public:
+	struct promise_type {
+		Signal* signal = nullptr;
+
+		struct FinalAwaiter {
+			bool await_ready() const noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept {
+				return finished.promise().signal->finished();
+			}
+			void await_resume() const noexcept {}
+		};
+
+		CoroTaskRunner get_return_object() { return CoroTaskRunner(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		FinalAwaiter final_suspend() const noexcept { return {}; }
+		void return_void() const noexcept {}
+		void unhandled_exception() const noexcept { std::terminate(); } // Awaiting completion() never throws.
+	};
+
+private:
+	std::coroutine_handle<promise_type> handle;
+
+public:
+	explicit CoroTaskRunner(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	CoroTaskRunner(CoroTaskRunner&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	CoroTaskRunner(const CoroTaskRunner&) = delete;
+	CoroTaskRunner& operator=(const CoroTaskRunner&) = delete;
+	CoroTaskRunner& operator=(CoroTaskRunner&&) = delete;
+
+	~CoroTaskRunner() {
+		if (handle) { handle.destroy(); }
+	}
+
+	void start(Signal* signal) {
+		handle.promise().signal = signal;
+		handle.resume();
+	}
+};
+
+template <typename Signal, typename T>
+CoroTaskRunner<Signal> runCoroTask(CoroTask<T>& task) {
+	co_await task.completion();
+}
+
+// Starts every runner and resumes the awaiting coroutine once all of them have finished. The count starts
+// one higher than the number of runners so that tasks finishing while the others are still being started
+// cannot resume the awaiting coroutine early.
+class WhenAllAwaiter
+{
+private:
+	std::vector<CoroTaskRunner<WhenAllAwaiter>>& runners;
+	std::atomic<size_t> remaining;
+	std::coroutine_handle<> awaiting;
+
+public:
+	explicit WhenAllAwaiter(std::vector<CoroTaskRunner<WhenAllAwaiter>>& runners)
+		: runners(runners), remaining(runners.size() + 1) {}
+
+	bool await_ready() const noexcept { return runners.empty(); }
+	bool await_suspend(std::coroutine_handle<> handle) {
+		awaiting = handle;
+		for (auto& runner : runners) {
+			runner.start(this);
+		}
+		return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+	}
+	void await_resume() const noexcept {}
+
+	std::coroutine_handle<> finished() noexcept {
+		if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) { return awaiting; }
+		return std::noop_coroutine();
+	}
+};
+
+// Runs the tasks concurrently and returns all of their results. Each task runs inline until its first
+// suspension, so tasks meant to run in parallel should begin with co_await scheduleOn(pool). If tasks throw,
+// the exception of the first of them in argument order is rethrown after all have finished.
+template <typename... Ts>
+CoroTask<std::tuple<Ts...>> whenAll(CoroTask<Ts>... tasks) {
+	static_assert((!std::is_void_v<Ts> && ...), "Use the vector overload of whenAll for tasks without a result.");
+	std::vector<CoroTaskRunner<WhenAllAwaiter>> runners;
+	runners.reserve(sizeof...(Ts));
+	(runners.push_back(runCoroTask<WhenAllAwaiter>(tasks)), ...);
+	co_await WhenAllAwaiter(runners);
+	co_return std::tuple<Ts...>{ tasks.result()... };
+}
+
+template <typename T>
+CoroTask<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> whenAll(std::vector<CoroTask<T>> tasks) {
+	std::vector<CoroTaskRunner<WhenAllAwaiter>> runners;
+	runners.reserve(tasks.size());
+	for (auto& task : tasks) {
+		runners.push_back(runCoroTask<WhenAllAwaiter>(task));
+	}
+	co_await WhenAllAwaiter(runners);
+
+	if constexpr (std::is_void_v<T>) {
+		for (auto& task : tasks) { task.result(); }
+	}
+	else {
+		std::vector<T> results;
+		results.reserve(tasks.size());
+		for (auto& task : tasks) { results.push_back(task.result()); }
+		co_return results;
+	}
+}
+
+// Lets a thread that is not a coroutine block until a task has finished.
+class SyncWaitSignal
+{
+private:
+	std::mutex signal_mutex;
+	std::condition_variable signal_changed;
+	bool done = false;
+
+public:
+	std::coroutine_handle<> finished() noexcept {
+		std::lock_guard<std::mutex> lock(signal_mutex);
+		done = true;
+		signal_changed.notify_one(); // Under the lock, so the waiter cannot destroy the signal before this returns.
+		return std::noop_coroutine();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(signal_mutex);
+		signal_changed.wait(lock, [this] { return done; });
+	}
+};
+
+// Runs the task, blocks the calling thread until it has finished and returns its result.
+// Must not be called from a worker of the pool the task runs on.
+template <typename T>
+T syncWait(CoroTask<T> task) {
+	SyncWaitSignal signal;
+	CoroTaskRunner<SyncWaitSignal> runner = runCoroTask<SyncWaitSignal>(task);
+	runner.start(&signal);
+	signal.wait();
+	return task.result();
+}
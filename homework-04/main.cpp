@@ -2,39 +2,13 @@
 #include <thread>
 #include <vector>
 #include <functional>
+#include <future>
 #include <regex>
 #include <unordered_map>
-
-class SimpleThreadPool
-{
-private:
-	std::vector<std::thread> threads;
-
-	void cleanup() {
-		for (auto& t : threads) {
-			if (t.joinable()) { t.join(); }
-		}
-	}
-
-public:
-	explicit SimpleThreadPool(const size_t numThreads) { threads.reserve(numThreads); }
-
-	SimpleThreadPool(const SimpleThreadPool&) = delete;
-	SimpleThreadPool& operator=(const SimpleThreadPool&) = delete;
-	SimpleThreadPool(SimpleThreadPool&&) = default;
-	SimpleThreadPool& operator=(SimpleThreadPool&&) = default;
-
-	template<typename Function, typename... Args>
-	void addTask(Function&& function, const std::string& taskName, Args&&... args) {
-		threads.emplace_back([function = std::forward<Function>(function), taskName, args...]() mutable {
-			std::cout << "Starting task: " << taskName << std::endl;
-			function(args...);
-			std::cout << "\nCompleted task: " << taskName << std::endl;
-			});
-	}
-
-	~SimpleThreadPool() { cleanup(); }
-};
+#include "coro_task.h"
+#include "parallel_math.h"
+#include "task_graph.h"
+#include "thread_pool.h"
 
 class Order {
 private:
@@ -178,12 +152,10 @@ void factorial(const size_t n = 15) {
 	std::cout << "Factorial of " << n << " is " << result << std::endl;
 }
 
-void squaresSum(const int start = 1, const int end = 1000) {
-	size_t sum = 0;
-
-	for (size_t i = start; i <= end; ++i) { sum += i * i; }
+void squaresSum(SimpleThreadPool& pool, const uint64_t start = 1, const uint64_t end = 1000) {
+	UInt128 sum = sumOfSquares(pool, start, end);
 
-	std::cout << "Sum of squares from numbers " << start << " to " << end << " is " << sum << std::endl;
+	std::cout << "Sum of squares from numbers " << start << " to " << end << " is " << sum.toString() << std::endl;
 }
 
 void fibonacci(const size_t end = 30) {
@@ -215,6 +187,34 @@ void simpleNum(const size_t till = 100) {
 	}
 }
 
+void primeCount(SimpleThreadPool& pool, const uint64_t till = 100000000) {
+	std::cout << "Number of primes till " << till << ": " << countPrimesUpTo(pool, till) << std::endl;
+}
+
+// The order flow as a coroutine: each stage moves to a worker of the pool, and between stages the flow
+// holds no thread at all.
+CoroTask<void> processOrdersAsync(SimpleThreadPool& pool, OrderProcessor& processor, std::vector<Order> rawOrders) {
+	co_await scheduleOn(pool);
+	std::cout << "[Flow 1] Validating orders...\n";
+	auto validatedOrders = processor.validateOrders(rawOrders);
+	std::cout << "[Flow 1] Completed.\n" << std::endl;
+
+	co_await scheduleOn(pool);
+	std::cout << "[Flow 2] Calculating prices...\n";
+	auto pricedOrders = processor.calculatePricing(validatedOrders);
+	std::cout << "[Flow 2] Completed.\n" << std::endl;
+
+	co_await scheduleOn(pool);
+	std::cout << "[Flow 3] Checking inventory...\n";
+	auto inStockOrders = processor.checkInventory(pricedOrders);
+	std::cout << "[Flow 3] Completed.\n" << std::endl;
+
+	co_await scheduleOn(pool);
+	std::cout << "[Flow 4] Generating invoices and sending to customers...\n";
+	processor.generateInvoices(inStockOrders);
+	std::cout << "[Flow 4] Completed.\n" << std::endl;
+}
+
 int main()
 {
 	std::cout << "--- Task 1: Parallel calculation of mathematical functions ---\n" << std::endl;
@@ -222,9 +222,41 @@ int main()
 	{
 		SimpleThreadPool pool(std::thread::hardware_concurrency());
 		pool.addTask(factorial, "Task 1", 15);
-		pool.addTask(squaresSum, "Task 2", 1, 1000);
+		pool.addTask([&pool] { squaresSum(pool, 1, 1000); }, "Task 2");
 		pool.addTask(fibonacci, "Task 3", 30);
 		pool.addTask(simpleNum, "Task 4", 100);
+		pool.addTask([&pool] { primeCount(pool, 100000000); }, "Task 5");
+		pool.waitIdle();
+		std::cout << std::endl;
+		pool.printMetrics(std::cout);
+	}
+
+	std::cout << "\n--- Task 1b: Priorities, delayed tasks and cancellation ---\n" << std::endl;
+
+	{
+		// One quiet worker, so the order in which the tasks run shows the scheduling.
+		SimpleThreadPool pool(1, false);
+		CancellationToken cancelled;
+		std::promise<void> started, released;
+		auto report = [](const std::string& text) { std::cout << text << std::endl; };
+
+		// Keeps the only worker busy until every other task has been added.
+		pool.addTask(TaskOptions{ .priority = TaskPriority::Low }, [&started, &released](const std::string& text) {
+			started.set_value();
+			released.get_future().wait();
+			std::cout << text << std::endl;
+			}, "Low 1", "Low priority, started first while the queue was empty");
+		started.get_future().wait();
+
+		pool.addTask(TaskOptions{ .delay = std::chrono::milliseconds(20) }, report, "Delayed", "Delayed by 20 ms, runs last");
+		pool.addTask(TaskOptions{ .priority = TaskPriority::Low }, report, "Low 2", "Low priority, runs after the higher ones");
+		pool.addTask(TaskOptions{ .priority = TaskPriority::Low, .cancellation = cancelled }, report, "Cancelled", "Cancelled, never printed");
+		pool.addTask(TaskOptions{ .priority = TaskPriority::High }, report, "High", "High priority, overtakes the waiting tasks");
+		pool.addTask(report, "Normal", "Normal priority");
+		cancelled.cancel();
+		released.set_value();
+		pool.waitIdle();
+		std::cout << "Cancelled tasks: " << pool.cancelledTasks() << std::endl;
 	}
 
 	std::cout << "\n--- Task 2: Order processing system ---\n" << std::endl;
@@ -237,38 +269,52 @@ int main()
 
 	OrderProcessor processor;
 
-	std::vector<Order> validatedOrders;
-	std::vector<Order> pricedOrders;
-	std::vector<Order> inStockOrders;
+	// Each stage is a task that receives the result of the previous one; the graph adds a stage to the pool
+	// as soon as its input is ready, so no thread sits in join() waiting for the one before it.
+	TaskGraph orderFlow;
 
-	std::thread t1([&processor, &rawOrders, &validatedOrders]() {
+	auto validatedOrders = orderFlow.add("Validate", [&processor, &rawOrders]() {
 		std::cout << "[Flow 1] Validating orders...\n";
-		validatedOrders = processor.validateOrders(rawOrders);
+		auto orders = processor.validateOrders(rawOrders);
 		std::cout << "[Flow 1] Completed.\n" << std::endl;
+		return orders;
 		});
 
-	std::thread t2([&processor, &validatedOrders, &pricedOrders, &t1]() {
-		t1.join();
+	auto pricedOrders = orderFlow.add("Price", [&processor](const std::vector<Order>& validOrders) {
 		std::cout << "[Flow 2] Calculating prices...\n";
-		pricedOrders = processor.calculatePricing(validatedOrders);
+		auto orders = processor.calculatePricing(validOrders);
 		std::cout << "[Flow 2] Completed.\n" << std::endl;
-		});
+		return orders;
+		}, validatedOrders);
 
-	std::thread t3([&processor, &pricedOrders, &inStockOrders, &t2]() {
-		t2.join();
+	auto inStockOrders = orderFlow.add("Check inventory", [&processor](const std::vector<Order>& priced) {
 		std::cout << "[Flow 3] Checking inventory...\n";
-		inStockOrders = processor.checkInventory(pricedOrders);
+		auto orders = processor.checkInventory(priced);
 		std::cout << "[Flow 3] Completed.\n" << std::endl;
-		});
+		return orders;
+		}, pricedOrders);
 
-	std::thread t4([&processor, &inStockOrders, &t3]() {
-		t3.join();
+	orderFlow.add("Invoice", [&processor](const std::vector<Order>& finalOrders) {
 		std::cout << "[Flow 4] Generating invoices and sending to customers...\n";
-		processor.generateInvoices(inStockOrders);
+		processor.generateInvoices(finalOrders);
 		std::cout << "[Flow 4] Completed.\n" << std::endl;
-		});
+		}, inStockOrders);
+
+	{
+		SimpleThreadPool pool(std::thread::hardware_concurrency(), false);
+		orderFlow.run(pool);
+	}
+	orderFlow.printTimings(std::cout);
 
-	t4.join();
+	std::cout << "\n--- Task 2b: The same order flow as a coroutine ---\n" << std::endl;
+
+	{
+		SimpleThreadPool pool(std::thread::hardware_concurrency(), false);
+		syncWait(processOrdersAsync(pool, processor, {
+			Order(4, {"Grilled Salmon", "Juice"}, "dave@example.com"),
+			Order(5, {"Chicken Alfredo", "Fruit Tart", "Coffee"}, "erin@example.org")
+		}));
+	}
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "thread_pool.h"
+
+// Data-parallel loops over index ranges on a SimpleThreadPool.
+// The calling thread works on the range too, and helper tasks added to the pool take chunks from a shared
+// counter, so a loop finishes even when every worker is busy, including when it is started from a task.
+
+// Without an explicit grain, the loop first runs growing prefixes of the range on the calling thread for
+// about PARALLEL_PROBE_TIME to measure the cost per index, then picks chunks that take about
+// PARALLEL_CHUNK_TIME, so the cost of a pool task stays well under 1%, but never fewer than
+// PARALLEL_CHUNKS_PER_THREAD chunks per thread, so that uneven chunks still balance. A rest that takes no
+// longer than one chunk runs on the calling thread alone.
+constexpr std::chrono::microseconds PARALLEL_PROBE_TIME{ 50 };
+constexpr std::chrono::microseconds PARALLEL_CHUNK_TIME{ 500 };
+constexpr size_t PARALLEL_CHUNKS_PER_THREAD = 4;
+
+// Chunks of one loop, shared by the caller and the helper tasks. Helpers that start after the loop has
+// finished find no chunk left and return without touching the loop body.
+class ParallelChunks
+{
+private:
+	std::function<void(size_t, size_t, size_t)> body; // (chunk, begin, end)
+	size_t begin;
+	size_t end;
+	size_t grain;
+	size_t chunks;
+	std::atomic<size_t> next_chunk{ 0 };
+	std::atomic<bool> failed{ false };
+
+	std::mutex chunks_mutex;
+	std::condition_variable all_finished;
+	size_t finished = 0;
+	std::exception_ptr first_error;
+
+public:
+	ParallelChunks(std::function<void(size_t, size_t, size_t)> body, size_t begin, size_t end, size_t grain)
+		: body(std::move(body)), begin(begin), end(end), grain(grain), chunks((end - begin + grain - 1) / grain) {}
+
+	size_t count() const { return chunks; }
+
+	// Runs chunks until none is left. After a chunk has thrown, the remaining ones are skipped.
+	void work() {
+		while (true) {
+			size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+			if (chunk >= chunks) { return; }
+			if (!failed.load(std::memory_order_relaxed)) {
+				size_t first = begin + chunk * grain;
+				try {
+					body(chunk, first, std::min(first + grain, end));
+				}
+				catch (...) {
+					failed.store(true, std::memory_order_relaxed);
+					std::lock_guard<std::mutex> lock(chunks_mutex);
+					if (!first_error) { first_error = std::current_exception(); }
+				}
+			}
+			std::lock_guard<std::mutex> lock(chunks_mutex);
+			if (++finished == chunks) { all_finished.notify_all(); }
+		}
+	}
+
+	// Waits for the chunks other threads are still running, then rethrows the first exception, if any.
+	void wait() {
+		std::unique_lock<std::mutex> lock(chunks_mutex);
+		all_finished.wait(lock, [this] { return finished == chunks; });
+		if (first_error) { std::rethrow_exception(first_error); }
+	}
+};
+
+// Runs body on [begin, end) in chunks of `grain` indices: one helper task per pool thread, plus the caller.
+// A single chunk runs on the caller alone. Helpers are quiet tasks, so a verbose pool does not announce them
+// and those that find no chunk left do not show up in the per name metrics.
+template <typename ChunkBody>
+void parallelChunks(SimpleThreadPool& pool, size_t begin, size_t end, size_t grain, ChunkBody&& body) {
+	if (begin >= end) { return; }
+	auto shared = std::make_shared<ParallelChunks>(std::ref(body), begin, end, grain);
+	size_t helpers = std::min(pool.threadCount(), shared->count() - 1);
+	TaskOptions options;
+	options.quiet = true;
+	for (size_t i = 0; i < helpers; ++i) {
+		pool.addTask(options, [shared] { shared->work(); }, "parallel");
+	}
+	shared->work();
+	shared->wait();
+}
+
+// Runs body on growing prefixes of [begin, end) until PARALLEL_PROBE_TIME has passed, moves begin past them
+// and returns the grain for the rest of the range: all of it if the rest takes no longer than one chunk, so
+// the caller finishes it without helper tasks.
+template <typename Body>
+size_t parallelProbe(SimpleThreadPool& pool, size_t& begin, size_t end, Body& body) {
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+	Clock::duration elapsed{ 0 };
+	size_t done = 0;
+	for (size_t size = 1; begin < end && elapsed < PARALLEL_PROBE_TIME; size *= 2) {
+		size_t count = std::min(size, end - begin);
+		body(begin, begin + count);
+		begin += count;
+		done += count;
+		elapsed = Clock::now() - start;
+	}
+	if (begin >= end) { return 1; }
+
+	double secondsPerIndex = std::chrono::duration<double>(elapsed).count() / done;
+	double byTime = std::chrono::duration<double>(PARALLEL_CHUNK_TIME).count() / std::max(secondsPerIndex, 1e-12);
+	if (byTime >= static_cast<double>(end - begin)) { return end - begin; }
+	size_t balanced = (end - begin) / ((pool.threadCount() + 1) * PARALLEL_CHUNKS_PER_THREAD);
+	return std::clamp<size_t>(static_cast<size_t>(std::min(byTime, 1e18)), 1, std::max<size_t>(balanced, 1));
+}
+
+// Calls body(first, last) for consecutive subranges covering [begin, end), in parallel. With grain 0 the
+// chunk size is chosen automatically; otherwise every chunk has `grain` indices.
+template <typename Body>
+void parallelFor(SimpleThreadPool& pool, size_t begin, size_t end, Body&& body, size_t grain = 0) {
+	if (grain == 0) { grain = parallelProbe(pool, begin, end, body); }
+	parallelChunks(pool, begin, end, grain, [&body](size_t, size_t first, size_t last) { body(first, last); });
+}
+
+// Computes map(first, last) for consecutive subranges covering [begin, end) in parallel and folds the results
+// with combine, starting from identity. The results are combined in the order of the subranges, so combine
+// only has to be associative and the result does not depend on the number of threads for a fixed grain.
+template <typename T, typename Map, typename Combine>
+T parallelReduce(SimpleThreadPool& pool, size_t begin, size_t end, T identity, Map&& map, Combine&& combine, size_t grain = 0) {
+	T result = identity;
+	if (grain == 0) {
+		auto probe = [&](size_t first, size_t last) { result = combine(result, map(first, last)); };
+		grain = parallelProbe(pool, begin, end, probe);
+	}
+	if (begin >= end) { return result; }
+
+	std::vector<T> partial((end - begin + grain - 1) / grain, identity);
+	parallelChunks(pool, begin, end, grain, [&](size_t chunk, size_t first, size_t last) { partial[chunk] = map(first, last); });
+	for (const T& value : partial) {
+		result = combine(result, value);
+	}
+	return result;
+}
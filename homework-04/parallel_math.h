@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parallel.h"
+
+// Unsigned 128-bit integer with just what the sums below need; a sum of squares up to 10^10 needs 99 bits.
+struct UInt128 {
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	UInt128& operator+=(const UInt128& other) {
+		low += other.low;
+		high += other.high + (low < other.low);
+		return *this;
+	}
+
+	friend UInt128 operator+(UInt128 a, const UInt128& b) { return a += b; }
+	friend bool operator==(const UInt128& a, const UInt128& b) = default;
+
+	static UInt128 multiply(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+		__extension__ typedef unsigned __int128 Wide;
+		Wide product = static_cast<Wide>(a) * b;
+		return { static_cast<uint64_t>(product >> 64), static_cast<uint64_t>(product) };
+#else
+		uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+		uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+		uint64_t low = aLow * bLow;
+		uint64_t middle1 = aHigh * bLow + (low >> 32);
+		uint64_t middle2 = aLow * bHigh + (middle1 & 0xFFFFFFFF);
+		return { aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32), (middle2 << 32) | (low & 0xFFFFFFFF) };
+#endif
+	}
+
+	// Decimal digits, by long division in 32-bit pieces.
+	std::string toString() const {
+		uint32_t parts[4] = { static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high), static_cast<uint32_t>(low >> 32), static_cast<uint32_t>(low) };
+		std::string digits;
+		do {
+			uint64_t remainder = 0;
+			for (uint32_t& part : parts) {
+				uint64_t current = (remainder << 32) | part;
+				part = static_cast<uint32_t>(current / 10);
+				remainder = current % 10;
+			}
+			digits.push_back(static_cast<char>('0' + remainder));
+		} while (parts[0] != 0 || parts[1] != 0 || parts[2] != 0 || parts[3] != 0);
+		return std::string(digits.rbegin(), digits.rend());
+	}
+};
+
+// begin^2 + ... + (end - 1)^2 on one thread. The compiler's 128-bit type, where there is one, adds with
+// a carry instruction; two sums let consecutive additions overlap, which more than halves the time per square.
+inline UInt128 squaresInRange(uint64_t begin, uint64_t end) {
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 Wide;
+	Wide even = 0, odd = 0;
+	uint64_t i = begin;
+	for (; i + 1 < end; i += 2) {
+		even += static_cast<Wide>(i) * i;
+		odd += static_cast<Wide>(i + 1) * (i + 1);
+	}
+	if (i < end) { even += static_cast<Wide>(i) * i; }
+	Wide sum = even + odd;
+	return { static_cast<uint64_t>(sum >> 64), static_cast<uint64_t>(sum) };
+#else
+	UInt128 sum;
+	for (uint64_t i = begin; i < end; ++i) {
+		sum += UInt128::multiply(i, i);
+	}
+	return sum;
+#endif
+}
+
+// first^2 + (first + 1)^2 + ... + last^2, summed in parallel.
+inline UInt128 sumOfSquares(SimpleThreadPool& pool, uint64_t first, uint64_t last) {
+	if (first > last) { return {}; }
+	if (last >= (uint64_t{ 1 } << 42)) {
+		throw std::invalid_argument("The sum of squares would not fit into 128 bits.");
+	}
+	return parallelReduce(pool, first, last + 1, UInt128{}, squaresInRange, std::plus<>());
+}
+
+// Odd numbers per sieve segment; one byte each, so a segment is 256 KiB and stays in the L2 cache.
+constexpr size_t SIEVE_SEGMENT = 1 << 18;
+
+// Odd primes up to limit, by a plain sieve of Eratosthenes.
+inline std::vector<uint32_t> oddPrimesUpTo(uint64_t limit) {
+	std::vector<uint8_t> composite(limit + 1);
+	std::vector<uint32_t> primes;
+	for (uint64_t i = 3; i <= limit; i += 2) {
+		if (composite[i]) { continue; }
+		primes.push_back(static_cast<uint32_t>(i));
+		for (uint64_t j = i * i; j <= limit; j += 2 * i) {
+			composite[j] = 1;
+		}
+	}
+	return primes;
+}
+
+// Number of primes up to and including limit, by a segmented sieve of Eratosthenes over the odd numbers:
+// every thread reuses one segment buffer, so memory stays small even for limits around 10^10.
+inline uint64_t countPrimesUpTo(SimpleThreadPool& pool, uint64_t limit) {
+	if (limit < 2) { return 0; }
+	uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(limit)));
+	while (root * root > limit) { --root; }
+	while ((root + 1) * (root + 1) <= limit) { ++root; }
+	std::vector<uint32_t> primes = oddPrimesUpTo(root);
+
+	uint64_t odds = (limit + 1) / 2; // Index i stands for the odd number 2i + 1.
+	size_t segments = static_cast<size_t>((odds + SIEVE_SEGMENT - 1) / SIEVE_SEGMENT);
+	uint64_t count = parallelReduce(pool, 0, segments, uint64_t{ 0 }, [&primes, odds](size_t first, size_t last) {
+		thread_local std::vector<uint8_t> sieve;
+		sieve.resize(SIEVE_SEGMENT);
+		uint64_t found = 0;
+		for (size_t segment = first; segment < last; ++segment) {
+			uint64_t low = segment * SIEVE_SEGMENT;
+			size_t size = static_cast<size_t>(std::min<uint64_t>(SIEVE_SEGMENT, odds - low));
+			std::fill(sieve.begin(), sieve.begin() + size, uint8_t{ 1 });
+
+			uint64_t lowValue = 2 * low + 1;
+			uint64_t highValue = 2 * (low + size) - 1;
+			for (uint64_t p : primes) {
+				if (p * p > highValue) { break; }
+				uint64_t start = std::max(p * p, (lowValue + p - 1) / p * p);
+				if (start % 2 == 0) { start += p; }
+				for (uint64_t j = (start - 1) / 2 - low; j < size; j += p) {
+					sieve[j] = 0;
+				}
+			}
+			found += std::accumulate(sieve.begin(), sieve.begin() + size, uint64_t{ 0 });
+		}
+		return found;
+	}, std::plus<>());
+	return count; // Index 0 stands for 1, which is not prime, but 2 is missing: the two cancel out.
+}
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Summary of a LatencyHistogram.
+struct LatencyStats {
+	uint64_t count = 0;
+	double mean_us = 0.0;
+	double p50_us = 0.0;
+	double p90_us = 0.0;
+	double p99_us = 0.0;
+	double max_us = 0.0;
+};
+
+// Log-linear histogram of durations: each power of two is split into 8 buckets, so a percentile is off by
+// at most 12.5%. Recording is one relaxed atomic increment, safe from any thread.
+class LatencyHistogram
+{
+private:
+	static constexpr size_t SUB_BUCKETS = 8;
+	static constexpr size_t BUCKETS = 64 * SUB_BUCKETS;
+
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+	std::atomic<uint64_t> total_ns{ 0 };
+	std::atomic<uint64_t> max_ns{ 0 };
+
+	static size_t bucketOf(uint64_t ns) {
+		if (ns < SUB_BUCKETS) { return static_cast<size_t>(ns); }
+		size_t exponent = std::bit_width(ns) - 1; // ns lies in [2^exponent, 2^(exponent + 1)).
+		size_t sub = static_cast<size_t>((ns >> (exponent - 3)) & (SUB_BUCKETS - 1));
+		return (exponent - 2) * SUB_BUCKETS + sub;
+	}
+
+	// Upper bound of a bucket, reported for the percentiles that fall into it.
+	static uint64_t bucketLimit(size_t bucket) {
+		if (bucket < SUB_BUCKETS) { return bucket; }
+		size_t exponent = bucket / SUB_BUCKETS + 2;
+		uint64_t sub = bucket % SUB_BUCKETS;
+		return ((SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1;
+	}
+
+public:
+	void record(std::chrono::nanoseconds duration) {
+		uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+		buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+		total_ns.fetch_add(ns, std::memory_order_relaxed);
+		uint64_t previous = max_ns.load(std::memory_order_relaxed);
+		while (ns > previous && !max_ns.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {}
+	}
+
+	LatencyStats stats() const {
+		std::array<uint64_t, BUCKETS> counts;
+		LatencyStats result;
+		for (size_t i = 0; i < BUCKETS; ++i) {
+			counts[i] = buckets[i].load(std::memory_order_relaxed);
+			result.count += counts[i];
+		}
+		if (result.count == 0) { return result; }
+
+		auto percentile = [&](double q) {
+			uint64_t rank = static_cast<uint64_t>(q * (result.count - 1)) + 1;
+			uint64_t seen = 0;
+			for (size_t i = 0; i < BUCKETS; ++i) {
+				seen += counts[i];
+				if (seen >= rank) { return bucketLimit(i) / 1000.0; }
+			}
+			return bucketLimit(BUCKETS - 1) / 1000.0;
+		};
+		result.mean_us = total_ns.load(std::memory_order_relaxed) / 1000.0 / result.count;
+		result.max_us = max_ns.load(std::memory_order_relaxed) / 1000.0;
+		result.p50_us = std::min(percentile(0.50), result.max_us);
+		result.p90_us = std::min(percentile(0.90), result.max_us);
+		result.p99_us = std::min(percentile(0.99), result.max_us);
+		return result;
+	}
+
+	// Adds the durations recorded by another histogram to this one.
+	void add(const LatencyHistogram& other) {
+		for (size_t i = 0; i < BUCKETS; ++i) {
+			buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		total_ns.fetch_add(other.total_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		uint64_t ns = other.max_ns.load(std::memory_order_relaxed);
+		uint64_t previous = max_ns.load(std::memory_order_relaxed);
+		while (ns > previous && !max_ns.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {}
+	}
+
+	void reset() {
+		for (auto& bucket : buckets) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		total_ns.store(0, std::memory_order_relaxed);
+		max_ns.store(0, std::memory_order_relaxed);
+	}
+};
+
+// One run of a task, kept for a Chrome trace. Times are nanoseconds since the metrics were created.
+struct TaskSpan {
+	const std::string* name; // The key of the task name in the recording worker's table.
+	uint64_t start_ns;
+	uint64_t end_ns;
+};
+
+// Metrics of all the tasks with one name, summed over the workers.
+struct TaskNameStats {
+	std::string name;
+	uint64_t count = 0;
+	double throughput_per_s = 0.0; // Tasks finished per second since the metrics were last reset.
+	LatencyStats queue_wait;       // From entering the ready queue to starting on a worker.
+	LatencyStats run_time;
+};
+
+// What one worker recorded. Only that worker writes it; the mutex is contended only while a report or a trace
+// is being read, so recording a task costs a hash lookup of its name and a few uncontended increments.
+// Aligned to a cache line so that workers do not write to each other's lines.
+class alignas(64) WorkerMetrics
+{
+private:
+	struct NameMetrics {
+		LatencyHistogram queue_wait;
+		LatencyHistogram run_time;
+		uint64_t count = 0;
+	};
+
+	mutable std::mutex metrics_mutex;
+	std::unordered_map<std::string, NameMetrics> by_name;
+	uint64_t busy_ns = 0;
+	std::vector<TaskSpan> spans;
+	uint64_t dropped_spans = 0;
+
+	friend class PoolMetrics;
+};
+
+// Per task name metrics, worker utilization, queue depth and an optional Chrome trace of a SimpleThreadPool.
+// Each worker records into its own WorkerMetrics; reports add them up.
+class PoolMetrics
+{
+private:
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<std::unique_ptr<WorkerMetrics>> workers;
+	const Clock::time_point epoch = Clock::now();
+	std::atomic<int64_t> since_ns{ 0 }; // When the metrics were last reset, relative to epoch.
+	std::atomic<size_t> peak_queue_depth{ 0 };
+	std::atomic<bool> tracing{ false };
+	std::atomic<size_t> span_limit{ 0 };
+
+	uint64_t nanosecondsOf(Clock::time_point time) const {
+		return static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count(), 0));
+	}
+
+	double secondsSinceReset() const {
+		double seconds = (nanosecondsOf(Clock::now()) - since_ns.load(std::memory_order_relaxed)) / 1e9;
+		return std::max(seconds, 1e-9);
+	}
+
+	static void writeJsonString(std::ostream& out, const std::string& text) {
+		out << '"';
+		for (char c : text) {
+			if (c == '"' || c == '\\') { out << '\\' << c; }
+			else if (static_cast<unsigned char>(c) < 0x20) {
+				out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+			}
+			else { out << c; }
+		}
+		out << '"';
+	}
+
+public:
+	explicit PoolMetrics(size_t workerCount) {
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i) {
+			workers.push_back(std::make_unique<WorkerMetrics>());
+		}
+	}
+
+	// Called by worker `worker` after running a task.
+	void record(size_t worker, const std::string& name, Clock::time_point ready, Clock::time_point start, Clock::time_point end) {
+		WorkerMetrics& metrics = *workers[worker];
+		std::lock_guard<std::mutex> lock(metrics.metrics_mutex);
+		auto entry = metrics.by_name.try_emplace(name).first;
+		entry->second.queue_wait.record(start - ready);
+		entry->second.run_time.record(end - start);
+		++entry->second.count;
+		metrics.busy_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+		if (tracing.load(std::memory_order_relaxed)) {
+			if (metrics.spans.size() < span_limit.load(std::memory_order_relaxed)) {
+				metrics.spans.push_back({ &entry->first, nanosecondsOf(start), nanosecondsOf(end) });
+			}
+			else {
+				++metrics.dropped_spans;
+			}
+		}
+	}
+
+	// Counts a run towards the worker's utilization only, for tasks that stay out of the per name metrics.
+	void recordBusy(size_t worker, Clock::time_point start, Clock::time_point end) {
+		WorkerMetrics& metrics = *workers[worker];
+		std::lock_guard<std::mutex> lock(metrics.metrics_mutex);
+		metrics.busy_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	// Called with the number of ready tasks after one has been queued.
+	void recordQueueDepth(size_t depth) {
+		size_t previous = peak_queue_depth.load(std::memory_order_relaxed);
+		while (depth > previous && !peak_queue_depth.compare_exchange_weak(previous, depth, std::memory_order_relaxed)) {}
+	}
+
+	size_t peakQueueDepth() const { return peak_queue_depth.load(std::memory_order_relaxed); }
+
+	std::vector<TaskNameStats> taskStats() const {
+		struct Totals {
+			LatencyHistogram queue_wait;
+			LatencyHistogram run_time;
+			uint64_t count = 0;
+		};
+		std::unordered_map<std::string, Totals> totals;
+		for (const auto& worker : workers) {
+			std::lock_guard<std::mutex> lock(worker->metrics_mutex);
+			for (const auto& [name, metrics] : worker->by_name) {
+				Totals& total = totals[name];
+				total.queue_wait.add(metrics.queue_wait);
+				total.run_time.add(metrics.run_time);
+				total.count += metrics.count;
+			}
+		}
+
+		double seconds = secondsSinceReset();
+		std::vector<TaskNameStats> result;
+		for (const auto& [name, total] : totals) {
+			result.push_back({ name, total.count, total.count / seconds, total.queue_wait.stats(), total.run_time.stats() });
+		}
+		std::sort(result.begin(), result.end(), [](const TaskNameStats& a, const TaskNameStats& b) { return a.name < b.name; });
+		return result;
+	}
+
+	// Fraction of the time since the last reset each worker spent running tasks.
+	std::vector<double> workerUtilization() const {
+		double seconds = secondsSinceReset();
+		std::vector<double> result;
+		for (const auto& worker : workers) {
+			std::lock_guard<std::mutex> lock(worker->metrics_mutex);
+			result.push_back(std::min(worker->busy_ns / 1e9 / seconds, 1.0));
+		}
+		return result;
+	}
+
+	void reset() {
+		for (const auto& worker : workers) {
+			std::lock_guard<std::mutex> lock(worker->metrics_mutex);
+			worker->by_name.clear();
+			worker->busy_ns = 0;
+			worker->spans.clear();
+			worker->dropped_spans = 0;
+		}
+		peak_queue_depth.store(0, std::memory_order_relaxed);
+		since_ns.store(static_cast<int64_t>(nanosecondsOf(Clock::now())), std::memory_order_relaxed);
+	}
+
+	// Starts keeping a span for every task run, at most maxSpansPerWorker per worker; later ones are counted as dropped.
+	void startTrace(size_t maxSpansPerWorker) {
+		for (const auto& worker : workers) {
+			std::lock_guard<std::mutex> lock(worker->metrics_mutex);
+			worker->spans.clear();
+			worker->spans.reserve(std::min<size_t>(maxSpansPerWorker, 4096));
+			worker->dropped_spans = 0;
+		}
+		span_limit.store(maxSpansPerWorker, std::memory_order_relaxed);
+		tracing.store(true, std::memory_order_relaxed);
+	}
+
+	void stopTrace() { tracing.store(false, std::memory_order_relaxed); }
+
+	// Writes the spans in the Trace Event format, which chrome://tracing and ui.perfetto.dev open:
+	// one complete ("X") event per task run, one row per worker.
+	void writeChromeTrace(std::ostream& out) const {
+		out << "{\"traceEvents\":[";
+		bool first = true;
+		uint64_t dropped = 0;
+		for (size_t i = 0; i < workers.size(); ++i) {
+			std::lock_guard<std::mutex> lock(workers[i]->metrics_mutex);
+			out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+				<< ",\"args\":{\"name\":\"worker " << i << "\"}}";
+			first = false;
+			for (const TaskSpan& span : workers[i]->spans) {
+				out << ",\n{\"name\":";
+				writeJsonString(out, *span.name);
+				out << ",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":" << i
+					<< ",\"ts\":" << span.start_ns / 1000 << '.' << std::setw(3) << std::setfill('0') << span.start_ns % 1000
+					<< ",\"dur\":" << (span.end_ns - span.start_ns) / 1000 << '.' << std::setw(3) << (span.end_ns - span.start_ns) % 1000
+					<< std::setfill(' ') << '}';
+			}
+			dropped += workers[i]->dropped_spans;
+		}
+		out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_spans\":" << dropped << "}}" << std::endl;
+	}
+
+	// Prints a table of the task names, then the utilization of every worker and the peak queue depth.
+	void print(std::ostream& out) const {
+		std::ios_base::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		std::vector<TaskNameStats> stats = taskStats();
+		size_t width = 4;
+		for (const auto& task : stats) {
+			width = std::max(width, task.name.size());
+		}
+
+		out << std::left << std::setw(static_cast<int>(width)) << "Task" << std::right
+			<< std::setw(9) << "count" << std::setw(12) << "per second"
+			<< std::setw(14) << "wait p50 us" << std::setw(14) << "wait p99 us"
+			<< std::setw(13) << "run p50 us" << std::setw(13) << "run p99 us" << std::setw(13) << "run max us" << std::endl;
+		out << std::fixed << std::setprecision(1);
+		for (const auto& task : stats) {
+			out << std::left << std::setw(static_cast<int>(width)) << task.name << std::right
+				<< std::setw(9) << task.count << std::setw(12) << task.throughput_per_s
+				<< std::setw(14) << task.queue_wait.p50_us << std::setw(14) << task.queue_wait.p99_us
+				<< std::setw(13) << task.run_time.p50_us << std::setw(13) << task.run_time.p99_us << std::setw(13) << task.run_time.max_us << std::endl;
+		}
+
+		out << "Worker utilization:";
+		for (double utilization : workerUtilization()) {
+			out << ' ' << utilization * 100.0 << '%';
+		}
+		out << "\nPeak queue depth: " << peakQueueDepth() << std::endl;
+		out.flags(flags);
+		out.precision(precision);
+	}
+};
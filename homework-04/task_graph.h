@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "thread_pool.h"
+
+class TaskGraph;
+
+// Handle to a task in a TaskGraph. Passing it to TaskGraph::add makes the new task depend on this one and
+// receive its result as an argument. get() returns the result once the graph has run.
+template <typename T>
+class TaskRef
+{
+private:
+	friend class TaskGraph;
+	size_t id = 0;
+	std::shared_ptr<std::optional<T>> result;
+
+public:
+	size_t node() const { return id; }
+
+	const T& get() const {
+		if (!result || !result->has_value()) {
+			throw std::logic_error("The task has not produced a result yet.");
+		}
+		return **result;
+	}
+};
+
+template <>
+class TaskRef<void>
+{
+private:
+	friend class TaskGraph;
+	size_t id = 0;
+
+public:
+	size_t node() const { return id; }
+};
+
+// Timing of one task in the last run, relative to the start of the run.
+struct TaskTiming {
+	std::string name;
+	double start_ms = 0.0;
+	double duration_ms = 0.0;
+	bool skipped = false;
+};
+
+// Runs tasks with dependencies on a SimpleThreadPool: every task is added to the pool as soon as its last
+// predecessor finishes, so independent branches run in parallel (fan-out) and a task with several inputs
+// waits for all of them (fan-in) without blocking a thread. Results flow from a task to its successors.
+// If a task throws, the tasks that depend on it are skipped and run() rethrows the first exception.
+// run() blocks the calling thread, so it must not be called from a task of the same pool.
+class TaskGraph
+{
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Node {
+		std::string name;
+		std::function<void()> work;
+		std::function<void()> reset; // Clears the result of the previous run; empty for tasks without one.
+		std::vector<size_t> successors;
+		size_t dependencies = 0;
+		std::atomic<size_t> remaining{ 0 };
+		std::atomic<bool> skipped{ false }; // Set when a predecessor failed or was skipped.
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+	std::vector<std::unique_ptr<Node>> nodes;
+
+	std::mutex run_mutex;
+	std::condition_variable run_finished;
+	size_t finished = 0;
+	std::exception_ptr first_error;
+	Clock::time_point run_start;
+	Clock::time_point run_end;
+
+	void addEdge(size_t before, size_t after) {
+		if (before >= nodes.size() || after >= nodes.size() || before == after) {
+			throw std::invalid_argument("Invalid task graph dependency.");
+		}
+		nodes[before]->successors.push_back(after);
+		++nodes[after]->dependencies;
+	}
+
+	// Kahn's algorithm; throws if some tasks can never become ready.
+	std::vector<size_t> topologicalOrder() const {
+		std::vector<size_t> pending(nodes.size());
+		std::vector<size_t> order;
+		order.reserve(nodes.size());
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			pending[i] = nodes[i]->dependencies;
+			if (pending[i] == 0) { order.push_back(i); }
+		}
+		for (size_t next = 0; next < order.size(); ++next) {
+			for (size_t successor : nodes[order[next]]->successors) {
+				if (--pending[successor] == 0) { order.push_back(successor); }
+			}
+		}
+		if (order.size() != nodes.size()) {
+			throw std::logic_error("The task graph has a cycle.");
+		}
+		return order;
+	}
+
+	void submit(SimpleThreadPool& pool, size_t id) {
+		pool.addTask([this, &pool, id] { execute(pool, id); }, nodes[id]->name);
+	}
+
+	void execute(SimpleThreadPool& pool, size_t id) {
+		Node& node = *nodes[id];
+		node.start = Clock::now();
+		bool failed = node.skipped.load(std::memory_order_acquire);
+		if (!failed) {
+			try {
+				node.work();
+			}
+			catch (...) {
+				failed = true;
+				std::lock_guard<std::mutex> lock(run_mutex);
+				if (!first_error) { first_error = std::current_exception(); }
+			}
+		}
+		node.end = Clock::now();
+
+		for (size_t successor : node.successors) {
+			Node& next = *nodes[successor];
+			if (failed) { next.skipped.store(true, std::memory_order_release); }
+			// acq_rel: the last predecessor to finish sees the results and timings of all the others.
+			if (next.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				submit(pool, successor);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(run_mutex);
+		if (++finished == nodes.size()) {
+			run_end = Clock::now();
+			run_finished.notify_all();
+		}
+	}
+
+	static double milliseconds(Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+public:
+	TaskGraph() = default;
+	TaskGraph(const TaskGraph&) = delete;
+	TaskGraph& operator=(const TaskGraph&) = delete;
+
+	// Adds a task that runs work(inputs.get()...) after all the input tasks. Returns a handle to its result.
+	template <typename F, typename... Inputs>
+	auto add(const std::string& name, F work, const TaskRef<Inputs>&... inputs) {
+		static_assert((!std::is_void_v<Inputs> && ...), "Tasks without a result can only be ordered with precede().");
+		using Result = std::invoke_result_t<F&, const Inputs&...>;
+
+		auto node = std::make_unique<Node>();
+		node->name = name;
+		TaskRef<Result> ref;
+		ref.id = nodes.size();
+		if constexpr (std::is_void_v<Result>) {
+			node->work = [work, inputs...]() mutable { work(**inputs.result...); };
+		}
+		else {
+			ref.result = std::make_shared<std::optional<Result>>();
+			node->work = [work, result = ref.result, inputs...]() mutable { result->emplace(work(**inputs.result...)); };
+			node->reset = [result = ref.result] { result->reset(); };
+		}
+		nodes.push_back(std::move(node));
+		(addEdge(inputs.id, ref.id), ...);
+		return ref;
+	}
+
+	// Makes `after` wait for `before` without passing a result.
+	template <typename A, typename B>
+	void precede(const TaskRef<A>& before, const TaskRef<B>& after) {
+		addEdge(before.id, after.id);
+	}
+
+	size_t size() const { return nodes.size(); }
+
+	// Runs every task once and waits until all have finished. Can be called again to rerun the graph; the
+	// results of the previous run are cleared first, so get() on a task that failed or was skipped throws.
+	void run(SimpleThreadPool& pool) {
+		topologicalOrder();
+		finished = 0;
+		first_error = nullptr;
+		for (auto& node : nodes) {
+			node->remaining.store(node->dependencies, std::memory_order_relaxed);
+			node->skipped.store(false, std::memory_order_relaxed);
+			if (node->reset) { node->reset(); }
+		}
+
+		run_start = run_end = Clock::now();
+		if (nodes.empty()) { return; }
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i]->dependencies == 0) { submit(pool, i); }
+		}
+
+		std::unique_lock<std::mutex> lock(run_mutex);
+		run_finished.wait(lock, [this] { return finished == nodes.size(); });
+		if (first_error) { std::rethrow_exception(first_error); }
+	}
+
+	// Timings of the last run, in the order the tasks were added.
+	std::vector<TaskTiming> timings() const {
+		std::vector<TaskTiming> result;
+		for (const auto& node : nodes) {
+			result.push_back({ node->name, milliseconds(node->start - run_start), milliseconds(node->end - node->start), node->skipped.load() });
+		}
+		return result;
+	}
+
+	// The chain of dependent tasks that determined the length of the last run: walking back from the task that
+	// finished last, each step goes to the predecessor that finished last. Returns task indices, first to last.
+	std::vector<size_t> criticalPath() const {
+		if (nodes.empty()) { return {}; }
+		std::vector<size_t> latestPredecessor(nodes.size(), SIZE_MAX);
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			for (size_t successor : nodes[i]->successors) {
+				size_t& latest = latestPredecessor[successor];
+				if (latest == SIZE_MAX || nodes[i]->end > nodes[latest]->end) { latest = i; }
+			}
+		}
+
+		size_t last = 0;
+		for (size_t i = 1; i < nodes.size(); ++i) {
+			if (nodes[i]->end > nodes[last]->end) { last = i; }
+		}
+		std::vector<size_t> path;
+		for (size_t id = last; id != SIZE_MAX; id = latestPredecessor[id]) {
+			path.push_back(id);
+		}
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+
+	// Prints when each task ran, the total work against the wall time, and the critical path.
+	void printTimings(std::ostream& out) const {
+		std::ios_base::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		double work = 0.0;
+		size_t width = 4;
+		for (const auto& node : nodes) {
+			work += milliseconds(node->end - node->start);
+			width = std::max(width, node->name.size());
+		}
+		out << std::fixed << std::setprecision(3)
+			<< "Task graph: " << nodes.size() << " tasks, wall time " << milliseconds(run_end - run_start)
+			<< " ms, total work " << work << " ms" << std::endl;
+		for (const auto& timing : timings()) {
+			out << "  " << std::left << std::setw(static_cast<int>(width)) << timing.name << std::right
+				<< "  start " << std::setw(9) << timing.start_ms << " ms  took " << std::setw(9) << timing.duration_ms << " ms"
+				<< (timing.skipped ? "  (skipped)" : "") << std::endl;
+		}
+
+		std::vector<size_t> path = criticalPath();
+		if (!path.empty()) {
+			double pathWork = 0.0;
+			out << "Critical path: ";
+			for (size_t i = 0; i < path.size(); ++i) {
+				pathWork += milliseconds(nodes[path[i]]->end - nodes[path[i]]->start);
+				out << (i > 0 ? " -> " : "") << nodes[path[i]]->name;
+			}
+			out << " (" << pathWork << " ms of work)" << std::endl;
+		}
+		out.flags(flags);
+		out.precision(precision);
+	}
+};
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "pool_metrics.h"
+
+// Workers always take the oldest task of the highest non-empty priority class.
+enum class TaskPriority {
+	High,
+	Normal,
+	Low
+};
+
+constexpr size_t TASK_PRIORITY_COUNT = 3;
+
+// Cooperative cancellation. Copies share one flag: cancel() on any copy cancels them all.
+// A task that has not started yet when its token is cancelled is dropped by the pool, a delayed one at once
+// rather than when it becomes due; a running task can poll isCancelled() and return early.
+class CancellationToken
+{
+private:
+	struct State {
+		std::atomic<bool> cancelled{ false };
+		std::mutex callbacks_mutex;
+		std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+		uint64_t next_callback = 1;
+	};
+
+	std::shared_ptr<State> state = std::make_shared<State>();
+
+public:
+	// Runs the registered callbacks on the calling thread, once, however often cancel() is called.
+	void cancel() {
+		if (state->cancelled.exchange(true, std::memory_order_acq_rel)) { return; }
+		std::lock_guard<std::mutex> lock(state->callbacks_mutex);
+		for (auto& [id, callback] : state->callbacks) {
+			callback();
+		}
+		state->callbacks.clear();
+	}
+
+	bool isCancelled() const { return state->cancelled.load(std::memory_order_acquire); }
+
+	// Registers a callback for cancel() and returns its id, or returns 0 without registering it if the token
+	// is already cancelled. Callbacks run under the token's lock, so a callback must not use this token.
+	uint64_t onCancel(std::function<void()> callback) {
+		std::lock_guard<std::mutex> lock(state->callbacks_mutex);
+		if (isCancelled()) { return 0; }
+		uint64_t id = state->next_callback++;
+		state->callbacks.emplace_back(id, std::move(callback));
+		return id;
+	}
+
+	// Unregisters a callback. Once this returns, the callback is not running and will not run.
+	void removeCallback(uint64_t id) {
+		if (id == 0) { return; }
+		std::lock_guard<std::mutex> lock(state->callbacks_mutex);
+		std::erase_if(state->callbacks, [id](const auto& entry) { return entry.first == id; });
+	}
+};
+
+struct TaskOptions {
+	TaskPriority priority = TaskPriority::Normal;
+	std::chrono::steady_clock::duration delay{ 0 }; // The task becomes ready this long after it is added.
+	CancellationToken cancellation{};
+	bool quiet = false; // Not announced by a verbose pool and left out of the per name metrics, e.g. helper tasks.
+};
+
+// A fixed set of worker threads running named tasks.
+// Tasks wait in one FIFO queue per priority class. Delayed tasks wait in a hashed timer wheel with
+// 1 ms slots, driven by a separate timer thread that sleeps whenever no task is delayed. Cancelling the
+// token of a delayed task wakes the timer thread, which takes the task out of the wheel.
+// The destructor waits until every task added so far, delayed ones included, has run or been cancelled.
+class SimpleThreadPool
+{
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Task {
+		std::function<void()> run;
+		std::string name;
+		TaskPriority priority;
+		bool quiet;
+		CancellationToken cancellation;
+		Clock::time_point ready; // When the task entered its ready queue; the queue wait is measured from here.
+	};
+
+	struct TimerEntry {
+		uint64_t due_tick;
+		Task task;
+		uint64_t cancel_callback; // Registered with the task's token; removed when the entry leaves the wheel.
+	};
+
+	static constexpr Clock::duration TICK = std::chrono::milliseconds(1);
+	static constexpr size_t WHEEL_SLOTS = 512;
+
+	std::mutex pool_mutex;
+	std::condition_variable work_available;
+	std::condition_variable idle;
+	std::array<std::deque<Task>, TASK_PRIORITY_COUNT> queues;
+	size_t queued = 0;
+	size_t unfinished = 0; // Tasks added and not yet run or dropped: queued, delayed and running.
+	bool stopping = false;
+
+	std::mutex timer_mutex;
+	std::condition_variable timer_changed;
+	std::array<std::vector<TimerEntry>, WHEEL_SLOTS> wheel;
+	size_t delayed = 0;
+	bool cancel_pending = false; // A delayed task's token was cancelled; the wheel is swept for it.
+	bool timer_stopping = false;
+	const Clock::time_point epoch = Clock::now();
+	uint64_t processed_tick = 0; // Every slot up to this tick has been fired.
+
+	std::array<LatencyHistogram, TASK_PRIORITY_COUNT> queue_latency;
+	PoolMetrics metrics;
+	std::atomic<uint64_t> cancelled_tasks{ 0 };
+	std::atomic<uint64_t> failed_tasks{ 0 };
+	bool verbose;
+
+	std::vector<std::thread> threads;
+	std::thread timer_thread;
+
+	uint64_t tickOf(Clock::time_point time) const {
+		return static_cast<uint64_t>(std::max<Clock::rep>((time - epoch) / TICK, 0));
+	}
+
+	// Puts a task into its ready queue; `added` for a new task, false for a delayed one that became due.
+	void enqueue(Task task, bool added) {
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			task.ready = Clock::now();
+			queues[static_cast<size_t>(task.priority)].push_back(std::move(task));
+			++queued;
+			if (added) { ++unfinished; }
+			metrics.recordQueueDepth(queued);
+		}
+		work_available.notify_one();
+	}
+
+	// The callback outlives neither the entry nor the pool: the timer thread removes it before the entry counts
+	// as finished, and removeCallback waits for a callback that is running.
+	void schedule(Task task, Clock::duration delay) {
+		uint64_t callback = task.cancellation.onCancel([this] { wakeForCancellation(); });
+		if (callback == 0) {
+			cancelled_tasks.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			++unfinished;
+		}
+		{
+			std::lock_guard<std::mutex> lock(timer_mutex);
+			// Rounded up, so a task never runs early.
+			uint64_t due = std::max(tickOf(Clock::now() + delay + TICK - Clock::duration(1)), processed_tick + 1);
+			wheel[due % WHEEL_SLOTS].push_back({ due, std::move(task), callback });
+			++delayed;
+		}
+		timer_changed.notify_one();
+	}
+
+	void wakeForCancellation() {
+		{
+			std::lock_guard<std::mutex> lock(timer_mutex);
+			cancel_pending = true;
+		}
+		timer_changed.notify_one();
+	}
+
+	// Moves the entries of one slot that are due by `tick` into `fired`, and cancelled ones into `dropped`.
+	void collectDue(std::vector<TimerEntry>& slot, uint64_t tick, std::vector<TimerEntry>& fired, std::vector<TimerEntry>& dropped) {
+		auto firstLater = std::partition(slot.begin(), slot.end(), [tick](const TimerEntry& entry) {
+			return entry.due_tick > tick && !entry.task.cancellation.isCancelled();
+		});
+		for (auto it = firstLater; it != slot.end(); ++it) {
+			(it->task.cancellation.isCancelled() ? dropped : fired).push_back(std::move(*it));
+		}
+		slot.erase(firstLater, slot.end());
+	}
+
+	// Called without timer_mutex, as cancel() holds the token's lock while its callbacks take timer_mutex.
+	void releaseTimerEntries(std::vector<TimerEntry>& fired, std::vector<TimerEntry>& dropped) {
+		for (auto& entry : fired) {
+			entry.task.cancellation.removeCallback(entry.cancel_callback);
+			enqueue(std::move(entry.task), false);
+		}
+		for (auto& entry : dropped) {
+			entry.task.cancellation.removeCallback(entry.cancel_callback);
+		}
+		if (!dropped.empty()) {
+			cancelled_tasks.fetch_add(dropped.size(), std::memory_order_relaxed);
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			unfinished -= dropped.size();
+			if (unfinished == 0) { idle.notify_all(); }
+		}
+		fired.clear();
+		dropped.clear();
+	}
+
+	void timerLoop() {
+		std::vector<TimerEntry> fired;
+		std::vector<TimerEntry> dropped;
+		std::unique_lock<std::mutex> lock(timer_mutex);
+		while (true) {
+			uint64_t target = tickOf(Clock::now());
+			if (delayed == 0) {
+				processed_tick = std::max(processed_tick, target);
+			}
+			else if (cancel_pending || target - processed_tick >= WHEEL_SLOTS) {
+				for (auto& slot : wheel) { collectDue(slot, target, fired, dropped); }
+				processed_tick = std::max(processed_tick, target);
+			}
+			else if (target > processed_tick) {
+				for (uint64_t tick = processed_tick + 1; tick <= target; ++tick) {
+					collectDue(wheel[tick % WHEEL_SLOTS], target, fired, dropped);
+				}
+				processed_tick = target;
+			}
+			cancel_pending = false;
+
+			if (!fired.empty() || !dropped.empty()) {
+				delayed -= fired.size() + dropped.size();
+				lock.unlock();
+				releaseTimerEntries(fired, dropped);
+				lock.lock();
+				continue;
+			}
+
+			if (timer_stopping) { return; }
+			if (delayed == 0) {
+				timer_changed.wait(lock);
+			}
+			else {
+				timer_changed.wait_until(lock, epoch + (processed_tick + 1) * TICK);
+			}
+		}
+	}
+
+	void workerLoop(size_t worker) {
+		std::unique_lock<std::mutex> lock(pool_mutex);
+		while (true) {
+			work_available.wait(lock, [this] { return queued > 0 || stopping; });
+			if (queued == 0) { return; }
+
+			auto queue = std::find_if(queues.begin(), queues.end(), [](const std::deque<Task>& tasks) { return !tasks.empty(); });
+			Task task = std::move(queue->front());
+			queue->pop_front();
+			--queued;
+			lock.unlock();
+
+			execute(task, worker);
+
+			lock.lock();
+			if (--unfinished == 0) { idle.notify_all(); }
+		}
+	}
+
+	void execute(Task& task, size_t worker) {
+		if (task.cancellation.isCancelled()) {
+			cancelled_tasks.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		Clock::time_point start = Clock::now();
+		queue_latency[static_cast<size_t>(task.priority)].record(start - task.ready);
+
+		if (verbose && !task.quiet) { std::cout << "Starting task: " << task.name << std::endl; }
+		try {
+			task.run();
+		}
+		catch (const std::exception& e) {
+			failed_tasks.fetch_add(1, std::memory_order_relaxed);
+			std::cerr << "Task " << task.name << " failed: " << e.what() << std::endl;
+		}
+		if (task.quiet) {
+			metrics.recordBusy(worker, start, Clock::now());
+			return;
+		}
+		metrics.record(worker, task.name, task.ready, start, Clock::now());
+		if (verbose) { std::cout << "\nCompleted task: " << task.name << std::endl; }
+	}
+
+	void cleanup() {
+		waitIdle();
+		{
+			std::lock_guard<std::mutex> lock(timer_mutex);
+			timer_stopping = true;
+		}
+		timer_changed.notify_one();
+		if (timer_thread.joinable()) { timer_thread.join(); }
+
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			stopping = true;
+		}
+		work_available.notify_all();
+		for (auto& t : threads) {
+			if (t.joinable()) { t.join(); }
+		}
+	}
+
+public:
+	// verbose prints "Starting task" and "Completed task" around every task.
+	explicit SimpleThreadPool(const size_t numThreads, bool verbose = true)
+		: metrics(std::max<size_t>(numThreads, 1)), verbose(verbose) {
+		size_t count = std::max<size_t>(numThreads, 1);
+		threads.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			threads.emplace_back([this, i] { workerLoop(i); });
+		}
+		timer_thread = std::thread([this] { timerLoop(); });
+	}
+
+	SimpleThreadPool(const SimpleThreadPool&) = delete;
+	SimpleThreadPool& operator=(const SimpleThreadPool&) = delete;
+
+	~SimpleThreadPool() { cleanup(); }
+
+	// Runs function(args...) with normal priority as soon as a worker is free.
+	template<typename Function, typename... Args>
+	void addTask(Function&& function, const std::string& taskName, Args&&... args) {
+		addTask(TaskOptions(), std::forward<Function>(function), taskName, std::forward<Args>(args)...);
+	}
+
+	// Runs function(args...) with the given priority, after the given delay, unless cancelled first.
+	template<typename Function, typename... Args>
+	void addTask(const TaskOptions& options, Function&& function, const std::string& taskName, Args&&... args) {
+		Task task{ [function = std::forward<Function>(function), ...args = std::forward<Args>(args)]() mutable { function(args...); },
+			taskName, options.priority, options.quiet, options.cancellation, {} };
+		if (options.delay > Clock::duration::zero()) {
+			schedule(std::move(task), options.delay);
+		}
+		else {
+			enqueue(std::move(task), true);
+		}
+	}
+
+	// Blocks until every task added so far has run or been cancelled, delayed ones included.
+	void waitIdle() {
+		std::unique_lock<std::mutex> lock(pool_mutex);
+		idle.wait(lock, [this] { return unfinished == 0; });
+	}
+
+	size_t threadCount() const { return threads.size(); }
+
+	// Time tasks of a priority class spent in the ready queue before a worker started them.
+	LatencyStats queueLatency(TaskPriority priority) const { return queue_latency[static_cast<size_t>(priority)].stats(); }
+	void resetStatistics() {
+		for (auto& histogram : queue_latency) {
+			histogram.reset();
+		}
+		metrics.reset();
+	}
+
+	// Queue wait, run time and throughput per task name, and worker utilization, since the last reset.
+	std::vector<TaskNameStats> taskStats() const { return metrics.taskStats(); }
+	std::vector<double> workerUtilization() const { return metrics.workerUtilization(); }
+	size_t peakQueueDepth() const { return metrics.peakQueueDepth(); }
+	void printMetrics(std::ostream& out) const { metrics.print(out); }
+
+	// Keeps a span per task run, at most maxSpansPerWorker per worker, for writeChromeTrace.
+	void startTrace(size_t maxSpansPerWorker = 1 << 20) { metrics.startTrace(maxSpansPerWorker); }
+	void stopTrace() { metrics.stopTrace(); }
+	void writeChromeTrace(std::ostream& out) const { metrics.writeChromeTrace(out); }
+
+	uint64_t cancelledTasks() const { return cancelled_tasks.load(std::memory_order_relaxed); }
+	uint64_t failedTasks() const { return failed_tasks.load(std::memory_order_relaxed); }
+};
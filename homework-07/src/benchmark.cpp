@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "movie_catalog.h"
+#include "title_search.h"
+
+using Clock = std::chrono::steady_clock;
+
+const std::vector<std::string> GENRE_NAMES = {
+	"Action", "Adventure", "Animation", "Biography", "Comedy", "Crime", "Documentary", "Drama", "Family", "Fantasy",
+	"History", "Horror", "Music", "Musical", "Mystery", "Romance", "Sci-Fi", "Sport", "Thriller", "Western"
+};
+
+const std::vector<std::string> TITLE_WORDS = {
+	"Last", "Night", "Winter", "Summer", "Shadow", "River", "City", "Stranger", "Dream", "Storm", "Silent", "Golden",
+	"Road", "Empire", "Heart", "Secret", "Lost", "Kingdom", "Fire", "Ocean", "Star", "Ghost", "Hunter", "Garden",
+	"Midnight", "Forgotten", "Wild", "Iron", "Glass", "Mountain", "Letter", "Journey", "Return", "Promise", "Echo", "Harbor"
+};
+
+const std::string ONSETS[] = { "b", "br", "c", "ch", "d", "dr", "f", "g", "gr", "h", "j", "k", "l", "m", "n", "p", "qu", "r", "s", "sh", "st", "t", "th", "tr", "v", "w", "z" };
+const std::string VOWELS[] = { "a", "e", "i", "o", "u", "ai", "ea", "ou", "y" };
+const std::string CODAS[] = { "", "", "", "n", "r", "l", "s", "th", "x", "nd", "rk", "m" };
+
+// A made-up name of two or three syllables, such as "Dralith" or "Vouskel".
+std::string makeName(std::mt19937& random) {
+	std::string name;
+	for (size_t i = 0, count = 2 + random() % 2; i < count; ++i) {
+		name += ONSETS[random() % std::size(ONSETS)] + VOWELS[random() % std::size(VOWELS)] + CODAS[random() % std::size(CODAS)];
+	}
+	name[0] = static_cast<char>(name[0] - 'a' + 'A');
+	return name;
+}
+
+// Titles such as "The Last Dralith", "Vouskel of the Storm" or "Chaxbe Trouma II": mostly distinct, with
+// common words shared by many of them.
+std::string makeTitle(std::mt19937& random) {
+	const std::string& word = TITLE_WORDS[random() % TITLE_WORDS.size()];
+	std::string title;
+	switch (random() % 4) {
+	case 0: title = "The " + word + " " + makeName(random); break;
+	case 1: title = makeName(random) + " of the " + word; break;
+	case 2: title = word + " " + makeName(random) + ": " + TITLE_WORDS[random() % TITLE_WORDS.size()]; break;
+	default: title = makeName(random) + " " + makeName(random); break;
+	}
+	if (random() % 10 == 0) { title += random() % 2 ? " II" : " 3"; }
+	return title;
+}
+
+// Deterministic movies with 1 to 3 genres, released 1920-2025, priced 1.99-24.99.
+std::vector<Movie> makeMovies(size_t count, unsigned seed) {
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<size_t> word(0, TITLE_WORDS.size() - 1);
+	std::uniform_int_distribution<int> genre(0, static_cast<int>(GENRE_NAMES.size()) - 1);
+	std::uniform_int_distribution<int> year(1920, 2025);
+	std::uniform_int_distribution<int> cents(199, 2499);
+	std::uniform_int_distribution<int> duration(70, 200);
+
+	std::vector<Movie> movies(count);
+	for (size_t i = 0; i < count; ++i) {
+		Movie& movie = movies[i];
+		movie.movieId = static_cast<int>(i + 1);
+		movie.title = makeTitle(random);
+		movie.description = "A story about " + TITLE_WORDS[word(random)] + " and " + TITLE_WORDS[word(random)] + ".";
+		movie.releaseYear = year(random);
+		movie.director = "Director " + std::to_string(random() % 5000);
+		movie.duration = duration(random);
+		movie.price = cents(random) / 100.0f;
+		movie.rentalPrice = movie.price / 4;
+		size_t genres = 1 + random() % 3;
+		while (movie.genreIds.size() < genres) {
+			int id = genre(random);
+			if (std::find(movie.genreIds.begin(), movie.genreIds.end(), id) == movie.genreIds.end()) {
+				movie.genreIds.push_back(id);
+			}
+		}
+	}
+	return movies;
+}
+
+// What browse does, without the columns and indexes: one pass over whole Movie objects.
+MovieQueryResult naiveBrowse(const std::vector<Movie>& movies, const MovieQuery& query) {
+	MovieQueryResult result;
+	std::vector<std::pair<int, size_t>> matches;
+	for (size_t i = 0; i < movies.size(); ++i) {
+		const Movie& movie = movies[i];
+		float price = query.useRentalPrice ? movie.rentalPrice : movie.price;
+		bool match = movie.releaseYear >= query.yearFrom && movie.releaseYear <= query.yearTo
+			&& price >= query.minPrice && price <= query.maxPrice;
+		for (size_t g = 0; match && g < query.genreIds.size(); ++g) {
+			match = std::find(movie.genreIds.begin(), movie.genreIds.end(), query.genreIds[g]) != movie.genreIds.end();
+		}
+		if (match) { matches.emplace_back(movie.releaseYear, i); }
+	}
+	result.total = matches.size();
+	if (query.order == MovieOrder::NewestFirst) {
+		std::sort(matches.begin(), matches.end(), std::greater<>());
+	}
+	for (size_t i = query.offset; i < matches.size() && result.movieIds.size() < query.limit; ++i) {
+		result.movieIds.push_back(movies[matches[i].second].movieId);
+	}
+	return result;
+}
+
+double percentile(std::vector<double>& samples, double fraction) {
+	size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+	std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+	return samples[index];
+}
+
+struct NamedQuery {
+	std::string label;
+	MovieQuery query;
+};
+
+// Latency of each query against the catalog and against the naive scan, after checking that both agree.
+void measureQueries(const MovieCatalog& catalog, const std::vector<Movie>& movies, const std::vector<NamedQuery>& queries, size_t repeats) {
+	std::cout << std::left << std::setw(44) << "Query" << std::right << std::setw(10) << "matches"
+		<< std::setw(14) << "p50 us" << std::setw(12) << "p99 us" << std::setw(14) << "scan p50 us" << std::setw(10) << "speedup" << std::endl;
+	for (const NamedQuery& named : queries) {
+		MovieQueryResult expected = naiveBrowse(movies, named.query);
+		MovieQueryResult actual = catalog.browse(named.query);
+		if (actual.total != expected.total || actual.movieIds != expected.movieIds) {
+			std::cerr << "Results differ for '" << named.label << "'.\n";
+			return;
+		}
+
+		std::vector<double> indexed, scanned;
+		for (size_t i = 0; i < repeats; ++i) {
+			auto start = Clock::now();
+			catalog.browse(named.query);
+			indexed.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+		}
+		for (size_t i = 0; i < std::max<size_t>(repeats / 10, 3); ++i) {
+			auto start = Clock::now();
+			naiveBrowse(movies, named.query);
+			scanned.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+		}
+		double p50 = percentile(indexed, 0.5);
+		double scanP50 = percentile(scanned, 0.5);
+		std::cout << std::left << std::setw(44) << named.label << std::right << std::setw(10) << actual.total
+			<< std::fixed << std::setprecision(1) << std::setw(14) << p50 << std::setw(12) << percentile(indexed, 0.99)
+			<< std::setw(14) << scanP50 << std::setw(9) << scanP50 / p50 << "x" << std::endl;
+	}
+}
+
+// Queries per second with `readers` threads browsing while one writer keeps changing prices.
+void measureConcurrentReaders(MovieCatalog& catalog, const std::vector<NamedQuery>& queries, size_t movieCount, std::chrono::milliseconds duration) {
+	for (size_t readers : { 1, 2, 4, 8 }) {
+		std::atomic<bool> stop{ false };
+		std::atomic<size_t> served{ 0 };
+		size_t updates = 0;
+
+		std::vector<std::thread> threads;
+		for (size_t r = 0; r < readers; ++r) {
+			threads.emplace_back([&, r] {
+				size_t done = 0;
+				for (size_t i = r; !stop.load(std::memory_order_relaxed); ++i) {
+					catalog.browse(queries[i % queries.size()].query);
+					++done;
+				}
+				served += done;
+			});
+		}
+		std::thread writer([&] {
+			std::mt19937 random(7);
+			while (!stop.load(std::memory_order_relaxed)) {
+				int movieId = static_cast<int>(1 + random() % movieCount);
+				float price = (199 + random() % 2300) / 100.0f;
+				catalog.updatePrices(movieId, price, price / 4);
+				++updates;
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		});
+
+		std::this_thread::sleep_for(duration);
+		stop = true;
+		for (auto& thread : threads) { thread.join(); }
+		writer.join();
+
+		double seconds = std::chrono::duration<double>(duration).count();
+		std::cout << std::setw(2) << readers << " readers: " << std::fixed << std::setprecision(0) << std::setw(9)
+			<< served / seconds << " queries/s, writer: " << std::setw(6) << updates / seconds << " price updates/s" << std::endl;
+	}
+}
+
+void printLatency(const std::string& label, std::vector<double>& samples) {
+	std::cout << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+		<< "p50 " << std::setw(8) << percentile(samples, 0.5) << " us   p99 " << std::setw(8) << percentile(samples, 0.99)
+		<< " us   (" << samples.size() << " queries)" << std::endl;
+}
+
+// The title with one letter of its longest word replaced, as a typing mistake would.
+std::string misspell(const std::string& title, std::mt19937& random) {
+	size_t start = 0, length = 0;
+	for (size_t i = 0; i < title.size();) {
+		size_t end = title.find(' ', i);
+		if (end == std::string::npos) { end = title.size(); }
+		if (end - i > length) { start = i; length = end - i; }
+		i = end + 1;
+	}
+	std::string typo = title;
+	if (length > 2) { typo[start + 1 + random() % (length - 2)] = static_cast<char>('a' + random() % 26); }
+	return typo;
+}
+
+// Build time and size of the title index, then autocomplete and fuzzy search latency on prefixes and
+// misspellings of random titles, against a scan of every title for the same prefixes.
+void measureTitleSearch(const std::vector<Movie>& movies, size_t queries) {
+	auto start = Clock::now();
+	TitleSearchIndex index(movies);
+	std::cout << "Build: " << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count() << " ms, "
+		<< index.dictionaryKeys() << " dictionary keys in " << index.dictionaryBytes() / (1 << 20) << " MiB, "
+		<< index.trigramCount() << " trigram lists in " << index.postingBytes() / (1 << 20) << " MiB\n" << std::endl;
+
+	std::mt19937 random(11);
+	std::vector<std::vector<double>> byLength(3);
+	std::vector<std::string> prefixes;
+	for (size_t i = 0; i < queries; ++i) {
+		std::string title = normalizeTitle(movies[random() % movies.size()].title);
+		size_t wordStart = 0;
+		for (size_t skip = random() % 3, space; skip > 0 && (space = title.find(' ', wordStart)) != std::string::npos; --skip) {
+			wordStart = space + 1;
+		}
+		size_t length = 1 + random() % 8;
+		std::string prefix = title.substr(wordStart, length);
+		prefixes.push_back(prefix);
+
+		auto begin = Clock::now();
+		std::vector<TitleMatch> matches = index.autocomplete(prefix, 10);
+		double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+		byLength[prefix.size() <= 2 ? 0 : prefix.size() <= 4 ? 1 : 2].push_back(us);
+		if (matches.empty()) { std::cerr << "No completion for '" << prefix << "'.\n"; }
+	}
+	printLatency("Autocomplete, 1-2 characters", byLength[0]);
+	printLatency("Autocomplete, 3-4 characters", byLength[1]);
+	printLatency("Autocomplete, 5-8 characters", byLength[2]);
+
+	std::vector<std::string> normalized;
+	for (const Movie& movie : movies) { normalized.push_back(normalizeTitle(movie.title)); }
+	std::vector<double> scanned;
+	for (size_t i = 0; i < 5; ++i) {
+		const std::string& prefix = prefixes[i];
+		auto begin = Clock::now();
+		std::vector<std::pair<std::string_view, size_t>> found;
+		for (size_t row = 0; row < normalized.size(); ++row) {
+			std::string_view title = normalized[row];
+			for (size_t at = 0; ; ++at) {
+				if (title.compare(at, prefix.size(), prefix) == 0) {
+					found.emplace_back(title.substr(at), row);
+					break;
+				}
+				at = title.find(' ', at);
+				if (at == std::string_view::npos) { break; }
+			}
+		}
+		std::partial_sort(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(std::min<size_t>(10, found.size())), found.end());
+		scanned.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+	}
+	printLatency("Autocomplete by scanning every title", scanned);
+
+	std::vector<double> fuzzy;
+	size_t recovered = 0;
+	for (size_t i = 0; i < queries; ++i) {
+		const Movie& movie = movies[random() % movies.size()];
+		std::string typo = misspell(movie.title, random);
+		auto begin = Clock::now();
+		std::vector<TitleMatch> matches = index.fuzzySearch(typo, 10);
+		fuzzy.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+		recovered += std::any_of(matches.begin(), matches.end(), [&movie](const TitleMatch& match) { return match.title == movie.title; });
+	}
+	printLatency("Fuzzy search, one wrong letter", fuzzy);
+	std::cout << "Misspelled title found in the top 10: " << std::fixed << std::setprecision(1) << 100.0 * recovered / queries << "%" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t movieCount = argc > 1 ? std::stoull(argv[1]) : 2000000;
+	auto duration = std::chrono::milliseconds(argc > 2 ? std::stoll(argv[2]) : 1000);
+
+	std::cout << "------ Building a catalog of " << movieCount << " movies ------\n" << std::endl;
+	std::vector<Movie> movies = makeMovies(movieCount, 42);
+
+	MovieCatalog catalog;
+	for (size_t i = 0; i < GENRE_NAMES.size(); ++i) {
+		catalog.addGenre({ static_cast<int>(i), GENRE_NAMES[i] });
+	}
+	auto start = Clock::now();
+	catalog.addMovies(movies);
+	std::cout << "Bulk load: " << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count() << " ms" << std::endl;
+
+	std::vector<NamedQuery> queries = {
+		{ "Everything, first page", MovieQuery{} },
+		{ "Drama", { .genreIds = { 7 } } },
+		{ "Drama, newest first", { .genreIds = { 7 }, .order = MovieOrder::NewestFirst } },
+		{ "Comedy + Romance", { .genreIds = { 4, 15 } } },
+		{ "Released 1990-1999", { .yearFrom = 1990, .yearTo = 1999 } },
+		{ "Sci-Fi, 2015-2025, under $10", { .genreIds = { 16 }, .yearFrom = 2015, .yearTo = 2025, .maxPrice = 9.99f } },
+		{ "Horror + Mystery, 1980s, rent under $2", { .genreIds = { 11, 14 }, .yearFrom = 1980, .yearTo = 1989, .maxPrice = 2.0f, .useRentalPrice = true } },
+		{ "Western, 2025, newest first, page 3", { .genreIds = { 19 }, .yearFrom = 2025, .order = MovieOrder::NewestFirst, .offset = 100 } },
+		{ "Action + Thriller + Crime", { .genreIds = { 0, 18, 5 } } }
+	};
+
+	std::cout << "\n------ Browse latency: bitmap indexes against a full scan ------\n" << std::endl;
+	measureQueries(catalog, movies, queries, 200);
+
+	std::cout << "\n------ Concurrent readers with a price-updating writer (" << duration.count() << " ms each) ------\n" << std::endl;
+	measureConcurrentReaders(catalog, queries, movieCount, duration);
+
+	std::cout << "\n------ Title search: autocomplete and fuzzy matching ------\n" << std::endl;
+	measureTitleSearch(movies, 2000);
+
+	return 0;
+}
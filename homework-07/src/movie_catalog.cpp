@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "movie_catalog.h"
+
+// MovieBitmap class
+
+MovieBitmap::MovieBitmap(size_t rows) : words((rows + 63) / 64, 0) {}
+
+MovieBitmap MovieBitmap::all(size_t rows) {
+	MovieBitmap bitmap(rows);
+	std::fill(bitmap.words.begin(), bitmap.words.end(), ~uint64_t{ 0 });
+	if (rows % 64 != 0) { bitmap.words.back() = (uint64_t{ 1 } << (rows % 64)) - 1; }
+	return bitmap;
+}
+
+void MovieBitmap::set(size_t row) {
+	if (row / 64 >= words.size()) { words.resize(row / 64 + 1, 0); }
+	words[row / 64] |= uint64_t{ 1 } << (row % 64);
+}
+
+void MovieBitmap::reset(size_t row) {
+	if (row / 64 < words.size()) { words[row / 64] &= ~(uint64_t{ 1 } << (row % 64)); }
+}
+
+bool MovieBitmap::test(size_t row) const {
+	return row / 64 < words.size() && (words[row / 64] >> (row % 64) & 1) != 0;
+}
+
+size_t MovieBitmap::count() const {
+	size_t total = 0;
+	for (uint64_t word : words) { total += static_cast<size_t>(std::popcount(word)); }
+	return total;
+}
+
+MovieBitmap& MovieBitmap::operator&=(const MovieBitmap& other) {
+	size_t common = std::min(words.size(), other.words.size());
+	for (size_t i = 0; i < common; ++i) { words[i] &= other.words[i]; }
+	words.resize(common);
+	return *this;
+}
+
+// SortedColumnIndex class
+
+template <typename T>
+size_t SortedColumnIndex<T>::blockOf(const Entry& entry) const {
+	auto block = std::lower_bound(blocks.begin(), blocks.end(), entry, [](const std::vector<Entry>& entries, const Entry& value) { return entries.back() < value; });
+	return std::min(static_cast<size_t>(block - blocks.begin()), blocks.size() - 1);
+}
+
+template <typename T>
+std::pair<size_t, size_t> SortedColumnIndex<T>::lowerBound(T low) const {
+	auto block = std::lower_bound(blocks.begin(), blocks.end(), low, [](const std::vector<Entry>& entries, T value) { return entries.back().first < value; });
+	if (block == blocks.end()) { return { blocks.size(), 0 }; }
+	auto entry = std::lower_bound(block->begin(), block->end(), low, [](const Entry& entry, T value) { return entry.first < value; });
+	return { static_cast<size_t>(block - blocks.begin()), static_cast<size_t>(entry - block->begin()) };
+}
+
+template <typename T>
+void SortedColumnIndex<T>::insert(T value, uint32_t row) {
+	Entry entry(value, row);
+	++entry_count;
+	if (blocks.empty()) {
+		blocks.emplace_back(1, entry);
+		return;
+	}
+	size_t block = blockOf(entry);
+	std::vector<Entry>& entries = blocks[block];
+	entries.insert(std::upper_bound(entries.begin(), entries.end(), entry), entry);
+	if (entries.size() > BLOCK_CAPACITY) {
+		auto middle = entries.begin() + static_cast<std::ptrdiff_t>(entries.size() / 2);
+		std::vector<Entry> upper(middle, entries.end());
+		entries.erase(middle, entries.end());
+		blocks.insert(blocks.begin() + static_cast<std::ptrdiff_t>(block) + 1, std::move(upper));
+	}
+}
+
+template <typename T>
+void SortedColumnIndex<T>::erase(T value, uint32_t row) {
+	if (blocks.empty()) { return; }
+	Entry entry(value, row);
+	size_t block = blockOf(entry);
+	std::vector<Entry>& entries = blocks[block];
+	auto it = std::lower_bound(entries.begin(), entries.end(), entry);
+	if (it == entries.end() || *it != entry) { return; }
+	entries.erase(it);
+	--entry_count;
+	if (entries.empty()) { blocks.erase(blocks.begin() + static_cast<std::ptrdiff_t>(block)); }
+}
+
+template <typename T>
+void SortedColumnIndex<T>::rebuild(const std::vector<T>& column, const MovieBitmap& liveRows) {
+	std::vector<Entry> entries;
+	liveRows.forEach([&](size_t row) {
+		entries.emplace_back(column[row], static_cast<uint32_t>(row));
+		return true;
+	});
+	std::sort(entries.begin(), entries.end());
+
+	// Half-full blocks leave room for inserts before the first split.
+	blocks.clear();
+	for (size_t first = 0; first < entries.size(); first += BLOCK_CAPACITY / 2) {
+		size_t last = std::min(first + BLOCK_CAPACITY / 2, entries.size());
+		blocks.emplace_back(entries.begin() + static_cast<std::ptrdiff_t>(first), entries.begin() + static_cast<std::ptrdiff_t>(last));
+	}
+	entry_count = entries.size();
+}
+
+template <typename T>
+size_t SortedColumnIndex<T>::count(T low, T high) const {
+	if (high < low) { return 0; }
+	auto [block, first] = lowerBound(low);
+	size_t total = 0;
+	for (; block < blocks.size(); ++block, first = 0) {
+		const std::vector<Entry>& entries = blocks[block];
+		if (!(high < entries.back().first)) {
+			total += entries.size() - first;
+			continue;
+		}
+		auto last = std::upper_bound(entries.begin() + static_cast<std::ptrdiff_t>(first), entries.end(), high, [](T value, const Entry& entry) { return value < entry.first; });
+		return total + static_cast<size_t>(last - entries.begin()) - first;
+	}
+	return total;
+}
+
+template class SortedColumnIndex<int>;
+template class SortedColumnIndex<float>;
+
+// MovieCatalog class
+
+std::shared_lock<std::shared_mutex> MovieCatalog::readLock() const {
+	std::lock_guard<std::mutex> gate(writer_gate);
+	return std::shared_lock<std::shared_mutex>(catalog_mutex);
+}
+
+std::unique_lock<std::shared_mutex> MovieCatalog::writeLock() {
+	std::lock_guard<std::mutex> gate(writer_gate);
+	return std::unique_lock<std::shared_mutex>(catalog_mutex);
+}
+
+uint32_t MovieCatalog::appendRow(const Movie& movie) {
+	if (row_of_movie.count(movie.movieId) != 0) {
+		throw std::invalid_argument("Movie " + std::to_string(movie.movieId) + " is already in the catalog.");
+	}
+	for (int genreId : movie.genreIds) { requireGenre(genreId); }
+
+	uint32_t row = static_cast<uint32_t>(movie_ids.size());
+	movie_ids.push_back(movie.movieId);
+	release_years.push_back(movie.releaseYear);
+	prices.push_back(movie.price);
+	rental_prices.push_back(movie.rentalPrice);
+	durations.push_back(movie.duration);
+	titles.push_back(movie.title);
+	descriptions.push_back(movie.description);
+	directors.push_back(movie.director);
+	movie_genres.push_back(movie.genreIds);
+
+	row_of_movie[movie.movieId] = row;
+	live_rows.set(row);
+	++live_count;
+	for (int genreId : movie.genreIds) { genre_rows[genreId].set(row); }
+	return row;
+}
+
+void MovieCatalog::indexRow(uint32_t row) {
+	year_index.insert(release_years[row], row);
+	price_index.insert(prices[row], row);
+	rental_price_index.insert(rental_prices[row], row);
+}
+
+void MovieCatalog::requireGenre(int genreId) const {
+	if (genres.count(genreId) == 0) {
+		throw std::invalid_argument("Unknown genre " + std::to_string(genreId) + ".");
+	}
+}
+
+Movie MovieCatalog::movieAt(uint32_t row) const {
+	return { movie_ids[row], titles[row], descriptions[row], release_years[row], directors[row],
+		durations[row], prices[row], rental_prices[row], movie_genres[row] };
+}
+
+template <typename T>
+void MovieCatalog::restrictToRange(MovieBitmap& matches, const SortedColumnIndex<T>& index, const std::vector<T>& column, T low, T high) const {
+	size_t inRangeCount = index.count(low, high);
+	const T* values = column.data();
+	if (matches.count() <= inRangeCount) {
+		matches.retain([values, low, high](size_t row) { return values[row] >= low && values[row] <= high; });
+	}
+	else if (inRangeCount * 16 < column.size()) {
+		MovieBitmap inRange(column.size());
+		index.forEach(low, high, [&inRange](uint32_t row) {
+			inRange.set(row);
+			return true;
+		});
+		matches &= inRange;
+	}
+	else {
+		matches &= MovieBitmap::fromPredicate(column.size(), [values, low, high](size_t row) { return values[row] >= low && values[row] <= high; });
+	}
+}
+
+void MovieCatalog::addGenre(const Genre& genre) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	genres[genre.genreId] = genre;
+	genre_rows.try_emplace(genre.genreId);
+}
+
+std::vector<Genre> MovieCatalog::getGenres() const {
+	std::shared_lock<std::shared_mutex> lock = readLock();
+	std::vector<Genre> result;
+	for (const auto& [id, genre] : genres) { result.push_back(genre); }
+	std::sort(result.begin(), result.end(), [](const Genre& a, const Genre& b) { return a.genreId < b.genreId; });
+	return result;
+}
+
+void MovieCatalog::addMovie(const Movie& movie) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	indexRow(appendRow(movie));
+}
+
+void MovieCatalog::addMovies(const std::vector<Movie>& movies) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	size_t reserved = movie_ids.size() + movies.size();
+	movie_ids.reserve(reserved);
+	release_years.reserve(reserved);
+	prices.reserve(reserved);
+	rental_prices.reserve(reserved);
+	durations.reserve(reserved);
+	titles.reserve(reserved);
+	descriptions.reserve(reserved);
+	directors.reserve(reserved);
+	movie_genres.reserve(reserved);
+
+	try {
+		for (const Movie& movie : movies) { appendRow(movie); }
+	}
+	catch (...) {
+		// The movies added before the invalid one stay; the indexes must still cover them.
+		year_index.rebuild(release_years, live_rows);
+		price_index.rebuild(prices, live_rows);
+		rental_price_index.rebuild(rental_prices, live_rows);
+		throw;
+	}
+	year_index.rebuild(release_years, live_rows);
+	price_index.rebuild(prices, live_rows);
+	rental_price_index.rebuild(rental_prices, live_rows);
+}
+
+bool MovieCatalog::removeMovie(int movieId) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	auto it = row_of_movie.find(movieId);
+	if (it == row_of_movie.end()) { return false; }
+	uint32_t row = it->second;
+
+	live_rows.reset(row);
+	--live_count;
+	for (int genreId : movie_genres[row]) { genre_rows[genreId].reset(row); }
+	year_index.erase(release_years[row], row);
+	price_index.erase(prices[row], row);
+	rental_price_index.erase(rental_prices[row], row);
+	row_of_movie.erase(it);
+	return true;
+}
+
+bool MovieCatalog::updatePrices(int movieId, float price, float rentalPrice) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	auto it = row_of_movie.find(movieId);
+	if (it == row_of_movie.end()) { return false; }
+	uint32_t row = it->second;
+
+	price_index.erase(prices[row], row);
+	rental_price_index.erase(rental_prices[row], row);
+	prices[row] = price;
+	rental_prices[row] = rentalPrice;
+	price_index.insert(price, row);
+	rental_price_index.insert(rentalPrice, row);
+	return true;
+}
+
+bool MovieCatalog::addGenreToMovie(int movieId, int genreId) {
+	std::unique_lock<std::shared_mutex> lock = writeLock();
+	requireGenre(genreId);
+	auto it = row_of_movie.find(movieId);
+	if (it == row_of_movie.end()) { return false; }
+	uint32_t row = it->second;
+
+	std::vector<int>& movieGenres = movie_genres[row];
+	if (std::find(movieGenres.begin(), movieGenres.end(), genreId) == movieGenres.end()) {
+		movieGenres.push_back(genreId);
+		genre_rows[genreId].set(row);
+	}
+	return true;
+}
+
+std::optional<Movie> MovieCatalog::getMovie(int movieId) const {
+	std::shared_lock<std::shared_mutex> lock = readLock();
+	auto it = row_of_movie.find(movieId);
+	if (it == row_of_movie.end()) { return std::nullopt; }
+	return movieAt(it->second);
+}
+
+std::vector<int> MovieCatalog::getMoviesByGenre(int genreId) const {
+	std::shared_lock<std::shared_mutex> lock = readLock();
+	std::vector<int> result;
+	auto it = genre_rows.find(genreId);
+	if (it == genre_rows.end()) { return result; }
+	it->second.forEach([&](size_t row) {
+		result.push_back(movie_ids[row]);
+		return true;
+	});
+	return result;
+}
+
+size_t MovieCatalog::size() const {
+	std::shared_lock<std::shared_mutex> lock = readLock();
+	return live_count;
+}
+
+MovieQueryResult MovieCatalog::browse(const MovieQuery& query) const {
+	std::shared_lock<std::shared_mutex> lock = readLock();
+	MovieQueryResult result;
+
+	MovieBitmap matches = live_rows;
+	for (int genreId : query.genreIds) {
+		auto it = genre_rows.find(genreId);
+		if (it == genre_rows.end()) { return result; }
+		matches &= it->second;
+	}
+	if (query.yearFrom != std::numeric_limits<int>::min() || query.yearTo != std::numeric_limits<int>::max()) {
+		restrictToRange(matches, year_index, release_years, query.yearFrom, query.yearTo);
+	}
+	if (query.minPrice > 0.0f || query.maxPrice != std::numeric_limits<float>::max()) {
+		if (query.useRentalPrice) {
+			restrictToRange(matches, rental_price_index, rental_prices, query.minPrice, query.maxPrice);
+		}
+		else {
+			restrictToRange(matches, price_index, prices, query.minPrice, query.maxPrice);
+		}
+	}
+
+	result.total = matches.count();
+	if (query.offset >= result.total || query.limit == 0) { return result; }
+	size_t wanted = std::min(query.limit, result.total - query.offset);
+	result.movieIds.reserve(wanted);
+
+	if (query.order == MovieOrder::Catalog) {
+		size_t skipped = 0;
+		matches.forEach([&](size_t row) {
+			if (skipped < query.offset) { ++skipped; return true; }
+			result.movieIds.push_back(movie_ids[row]);
+			return result.movieIds.size() < wanted;
+		});
+	}
+	else if (result.total * 16 < movie_ids.size()) {
+		// Few matches: sort just them, newest first and, within a year, the latest added first.
+		std::vector<std::pair<int, uint32_t>> rows;
+		rows.reserve(result.total);
+		matches.forEach([&](size_t row) {
+			rows.emplace_back(release_years[row], static_cast<uint32_t>(row));
+			return true;
+		});
+		auto pageEnd = rows.begin() + static_cast<std::ptrdiff_t>(query.offset + wanted);
+		std::partial_sort(rows.begin(), pageEnd, rows.end(), std::greater<>());
+		for (auto it = rows.begin() + static_cast<std::ptrdiff_t>(query.offset); it != pageEnd; ++it) {
+			result.movieIds.push_back(movie_ids[it->second]);
+		}
+	}
+	else {
+		// Many matches: walk the year index from the newest end until the page is full.
+		size_t skipped = 0;
+		year_index.forEachDescending([&](uint32_t row) {
+			if (!matches.test(row)) { return true; }
+			if (skipped < query.offset) { ++skipped; return true; }
+			result.movieIds.push_back(movie_ids[row]);
+			return result.movieIds.size() < wanted;
+		});
+	}
+	return result;
+}
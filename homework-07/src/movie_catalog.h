@@ -0,0 +1,236 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A film, as in the class diagram; genres are referenced by genreId.
+struct Movie {
+	int movieId = 0;
+	std::string title;
+	std::string description;
+	int releaseYear = 0;
+	std::string director;
+	int duration = 0; // Minutes.
+	float price = 0.0f;
+	float rentalPrice = 0.0f;
+	std::vector<int> genreIds;
+};
+
+struct Genre {
+	int genreId = 0;
+	std::string name;
+};
+
+// A set of catalog rows, one bit per row. Rows beyond the end of the bitmap are not in the set.
+class MovieBitmap {
+private:
+	std::vector<uint64_t> words;
+
+public:
+	MovieBitmap() = default;
+	explicit MovieBitmap(size_t rows);
+
+	// Every row in [0, rows).
+	static MovieBitmap all(size_t rows);
+
+	// The rows in [0, rows) for which matches(row) is true, built 64 rows at a time.
+	template <typename Predicate>
+	static MovieBitmap fromPredicate(size_t rows, Predicate matches) {
+		MovieBitmap bitmap(rows);
+		for (size_t w = 0; w < bitmap.words.size(); ++w) {
+			size_t first = w * 64;
+			size_t last = first + 64 < rows ? first + 64 : rows;
+			uint64_t bits = 0;
+			for (size_t row = first; row < last; ++row) {
+				bits |= static_cast<uint64_t>(matches(row)) << (row - first);
+			}
+			bitmap.words[w] = bits;
+		}
+		return bitmap;
+	}
+
+	void set(size_t row);
+	void reset(size_t row);
+	bool test(size_t row) const;
+	size_t count() const;
+	size_t capacity() const { return words.size() * 64; }
+
+	MovieBitmap& operator&=(const MovieBitmap& other);
+
+	// Removes the rows for which keep(row) is false, looking only at the rows in the set.
+	template <typename Predicate>
+	void retain(Predicate keep) {
+		for (size_t w = 0; w < words.size(); ++w) {
+			uint64_t word = words[w];
+			while (word != 0) {
+				size_t bit = static_cast<size_t>(std::countr_zero(word));
+				if (!keep(w * 64 + bit)) { words[w] &= ~(uint64_t{ 1 } << bit); }
+				word &= word - 1;
+			}
+		}
+	}
+
+	// Calls visit(row) for every row in the set, in increasing order, until it returns false.
+	template <typename Visit>
+	void forEach(Visit visit) const {
+		for (size_t w = 0; w < words.size(); ++w) {
+			uint64_t word = words[w];
+			while (word != 0) {
+				size_t bit = static_cast<size_t>(std::countr_zero(word));
+				if (!visit(w * 64 + bit)) { return; }
+				word &= word - 1;
+			}
+		}
+	}
+};
+
+// Rows sorted by the value of one column, for range predicates and ordering.
+// The entries are kept in sorted blocks of at most BLOCK_CAPACITY, so adding or removing a row shifts the
+// entries of one block rather than of the whole index; a full block is split in two.
+template <typename T>
+class SortedColumnIndex {
+private:
+	using Entry = std::pair<T, uint32_t>; // (value, row)
+
+	static constexpr size_t BLOCK_CAPACITY = 512;
+
+	std::vector<std::vector<Entry>> blocks; // Sorted, none empty; every entry of a block precedes the next block.
+	size_t entry_count = 0;
+
+	// The block that holds, or would hold, the entry.
+	size_t blockOf(const Entry& entry) const;
+	// Block and position of the first entry with value >= low.
+	std::pair<size_t, size_t> lowerBound(T low) const;
+
+public:
+	void insert(T value, uint32_t row);
+	void erase(T value, uint32_t row);
+	void rebuild(const std::vector<T>& column, const MovieBitmap& liveRows);
+
+	// The number of entries with low <= value <= high.
+	size_t count(T low, T high) const;
+
+	// Calls visit(row) for the entries with low <= value <= high, in order, while it returns true.
+	template <typename Visit>
+	void forEach(T low, T high, Visit visit) const {
+		for (auto [block, i] = lowerBound(low); block < blocks.size(); ++block, i = 0) {
+			for (const std::vector<Entry>& entries = blocks[block]; i < entries.size(); ++i) {
+				if (high < entries[i].first || !visit(entries[i].second)) { return; }
+			}
+		}
+	}
+
+	// Calls visit(row) for every entry from the largest value down, while it returns true.
+	template <typename Visit>
+	void forEachDescending(Visit visit) const {
+		for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+			for (auto entry = block->rbegin(); entry != block->rend(); ++entry) {
+				if (!visit(entry->second)) { return; }
+			}
+		}
+	}
+
+	size_t size() const { return entry_count; }
+};
+
+enum class MovieOrder {
+	Catalog,     // The order the movies were added in.
+	NewestFirst  // By releaseYear, newest first.
+};
+
+// A browse query: every condition must hold. Prices are purchase prices unless useRentalPrice is set.
+struct MovieQuery {
+	std::vector<int> genreIds{}; // The movie must have all of these genres.
+	int yearFrom = std::numeric_limits<int>::min();
+	int yearTo = std::numeric_limits<int>::max();
+	float minPrice = 0.0f;
+	float maxPrice = std::numeric_limits<float>::max();
+	bool useRentalPrice = false;
+	MovieOrder order = MovieOrder::Catalog;
+	size_t offset = 0;
+	size_t limit = 50;
+};
+
+struct MovieQueryResult {
+	size_t total = 0;          // Movies matching the query.
+	std::vector<int> movieIds; // The requested page of them.
+};
+
+// In-memory movie catalog for the "Browse Movies" use case.
+// Movies are stored column by column: a query that filters on years and prices reads only those columns,
+// and the long text columns stay out of the cache. Secondary indexes turn every condition into a bitmap of
+// rows: one bitmap per genre, and sorted indexes on releaseYear, price and rentalPrice for ranges. A query
+// intersects the bitmaps 64 rows per instruction and then reads only the page it returns.
+// Queries take a shared lock and run in parallel; adding, changing and removing movies take an exclusive lock
+// and go ahead of queries that arrive after them.
+class MovieCatalog {
+private:
+	mutable std::shared_mutex catalog_mutex;
+	mutable std::mutex writer_gate;
+
+	// Columns, indexed by row. Rows of removed movies stay, marked dead in live_rows.
+	std::vector<int> movie_ids;
+	std::vector<int> release_years;
+	std::vector<float> prices;
+	std::vector<float> rental_prices;
+	std::vector<int> durations;
+	std::vector<std::string> titles;
+	std::vector<std::string> descriptions;
+	std::vector<std::string> directors;
+	std::vector<std::vector<int>> movie_genres;
+	MovieBitmap live_rows;
+	size_t live_count = 0;
+
+	std::unordered_map<int, uint32_t> row_of_movie;
+	std::unordered_map<int, Genre> genres;
+	std::unordered_map<int, MovieBitmap> genre_rows;
+	SortedColumnIndex<int> year_index;
+	SortedColumnIndex<float> price_index;
+	SortedColumnIndex<float> rental_price_index;
+
+	// A writer holds writer_gate while it waits for the running queries to finish, and new queries pass through
+	// the gate first, so a steady stream of queries cannot keep the writers out.
+	std::shared_lock<std::shared_mutex> readLock() const;
+	std::unique_lock<std::shared_mutex> writeLock();
+
+	uint32_t appendRow(const Movie& movie);
+	void indexRow(uint32_t row);
+	void requireGenre(int genreId) const;
+	Movie movieAt(uint32_t row) const;
+
+	// Narrows matches to the rows whose column value lies in [low, high], by the cheapest of three ways:
+	// checking the value of each row still in matches when there are fewer of them than rows in the range,
+	// setting bits from the sorted index when the range is narrow, or otherwise scanning the whole column,
+	// which is sequential and cheaper than scattering many bits.
+	template <typename T>
+	void restrictToRange(MovieBitmap& matches, const SortedColumnIndex<T>& index, const std::vector<T>& column, T low, T high) const;
+
+public:
+	void addGenre(const Genre& genre);
+	std::vector<Genre> getGenres() const;
+
+	// Adds a movie; throws std::invalid_argument for a duplicate movieId or an unknown genre.
+	void addMovie(const Movie& movie);
+
+	// Adds many movies and rebuilds the sorted indexes once, instead of inserting into them one by one.
+	void addMovies(const std::vector<Movie>& movies);
+
+	bool removeMovie(int movieId);
+	bool updatePrices(int movieId, float price, float rentalPrice);
+	bool addGenreToMovie(int movieId, int genreId);
+
+	std::optional<Movie> getMovie(int movieId) const;
+	std::vector<int> getMoviesByGenre(int genreId) const;
+	size_t size() const;
+
+	MovieQueryResult browse(const MovieQuery& query) const;
+};
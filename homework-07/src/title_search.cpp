@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "title_search.h"
+
+// Variable-length integers: seven bits per byte, low bits first, the high bit set on every byte but the last.
+
+static void writeVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+	while (value >= 0x80) {
+		bytes.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t readVarint(const uint8_t*& bytes) {
+	uint32_t value = *bytes & 0x7F;
+	for (int shift = 7; *bytes++ & 0x80; shift += 7) {
+		value |= static_cast<uint32_t>(*bytes & 0x7F) << shift;
+	}
+	return value;
+}
+
+std::string normalizeTitle(std::string_view title) {
+	std::string normalized;
+	normalized.reserve(title.size());
+	bool space = false;
+	for (char c : title) {
+		unsigned char byte = static_cast<unsigned char>(c);
+		bool word = byte >= 0x80 || (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z');
+		if (!word) {
+			space = !normalized.empty();
+			continue;
+		}
+		if (space) { normalized.push_back(' '); }
+		space = false;
+		normalized.push_back(byte >= 'A' && byte <= 'Z' ? static_cast<char>(byte - 'A' + 'a') : c);
+	}
+	return normalized;
+}
+
+size_t intersectSorted(const uint32_t* a, size_t aCount, const uint32_t* b, size_t bCount, std::vector<uint32_t>& matches) {
+	size_t found = matches.size();
+	size_t i = 0, j = 0;
+#ifdef __SSE2__
+	// Compares a[i..i+3] with b[j..j+3] in all four rotations; whichever block ends lower is used up.
+	while (i + 4 <= aCount && j + 4 <= bCount) {
+		__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+		__m128i equal = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+		while (mask != 0) {
+			int bit = std::countr_zero(static_cast<unsigned>(mask));
+			matches.push_back(static_cast<uint32_t>(i + bit));
+			mask &= mask - 1;
+		}
+		uint32_t aLast = a[i + 3], bLast = b[j + 3];
+		if (aLast <= bLast) { i += 4; }
+		if (bLast <= aLast) { j += 4; }
+	}
+#endif
+	while (i < aCount && j < bCount) {
+		if (a[i] < b[j]) { ++i; }
+		else if (b[j] < a[i]) { ++j; }
+		else {
+			matches.push_back(static_cast<uint32_t>(i));
+			++i;
+			++j;
+		}
+	}
+	return matches.size() - found;
+}
+
+// TitleSearchIndex class
+
+TitleSearchIndex::TitleSearchIndex(const std::vector<Movie>& movies) {
+	if (movies.size() > std::numeric_limits<uint32_t>::max()) {
+		throw std::invalid_argument("Too many movies for a title index.");
+	}
+	std::vector<std::string> normalized;
+	normalized.reserve(movies.size());
+	movie_ids.reserve(movies.size());
+	titles.reserve(movies.size());
+	for (const Movie& movie : movies) {
+		movie_ids.push_back(movie.movieId);
+		titles.push_back(movie.title);
+		normalized.push_back(normalizeTitle(movie.title));
+	}
+	buildDictionary(normalized);
+	buildPostings(normalized);
+}
+
+std::vector<uint32_t> TitleSearchIndex::trigrams(std::string_view normalized) {
+	std::vector<uint32_t> grams;
+	size_t start = 0;
+	while (start < normalized.size()) {
+		size_t end = std::min(normalized.find(' ', start), normalized.size());
+		std::string padded = "  " + std::string(normalized.substr(start, end - start)) + " ";
+		for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+			grams.push_back(static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16
+				| static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8
+				| static_cast<unsigned char>(padded[i + 2]));
+		}
+		start = end + 1;
+	}
+	std::sort(grams.begin(), grams.end());
+	grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+	return grams;
+}
+
+void TitleSearchIndex::buildDictionary(const std::vector<std::string>& normalized) {
+	std::vector<std::pair<std::string_view, uint32_t>> keys;
+	for (size_t row = 0; row < normalized.size(); ++row) {
+		std::string_view title = normalized[row];
+		for (size_t start = 0; !title.empty(); ) {
+			keys.emplace_back(title.substr(start), static_cast<uint32_t>(row));
+			size_t space = title.find(' ', start);
+			if (space == std::string_view::npos) { break; }
+			start = space + 1;
+		}
+	}
+	std::sort(keys.begin(), keys.end());
+
+	// Entry: shared length, rest length, rest, row. The first entry of a block shares nothing.
+	std::string_view previous;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		const auto& [key, row] = keys[i];
+		size_t shared = 0;
+		if (i % DICTIONARY_BLOCK == 0) {
+			if (dictionary_bytes.size() > std::numeric_limits<uint32_t>::max()) {
+				throw std::length_error("The title dictionary is larger than 4 GiB.");
+			}
+			dictionary_blocks.push_back(static_cast<uint32_t>(dictionary_bytes.size()));
+		}
+		else {
+			size_t most = std::min(previous.size(), key.size());
+			while (shared < most && previous[shared] == key[shared]) { ++shared; }
+		}
+		writeVarint(dictionary_bytes, static_cast<uint32_t>(shared));
+		writeVarint(dictionary_bytes, static_cast<uint32_t>(key.size() - shared));
+		dictionary_bytes.insert(dictionary_bytes.end(), key.begin() + shared, key.end());
+		writeVarint(dictionary_bytes, row);
+		previous = key;
+	}
+	dictionary_keys = keys.size();
+}
+
+void TitleSearchIndex::buildPostings(const std::vector<std::string>& normalized) {
+	// Rows come in increasing order, so every list is compressed as it grows.
+	struct ListBuilder {
+		std::vector<PostingBlock> blocks; // Offsets relative to bytes.
+		std::vector<uint8_t> bytes;
+		uint32_t last = 0;
+		uint32_t count = 0;
+	};
+	std::unordered_map<uint32_t, ListBuilder> builders;
+
+	trigram_counts.reserve(normalized.size());
+	for (size_t row = 0; row < normalized.size(); ++row) {
+		std::vector<uint32_t> grams = trigrams(normalized[row]);
+		trigram_counts.push_back(static_cast<uint16_t>(std::min<size_t>(grams.size(), std::numeric_limits<uint16_t>::max())));
+		for (uint32_t gram : grams) {
+			ListBuilder& builder = builders[gram];
+			if (builder.count % POSTING_BLOCK == 0) {
+				builder.blocks.push_back({ static_cast<uint32_t>(row), static_cast<uint32_t>(builder.bytes.size()) });
+			}
+			else {
+				writeVarint(builder.bytes, static_cast<uint32_t>(row) - builder.last);
+			}
+			builder.last = static_cast<uint32_t>(row);
+			++builder.count;
+		}
+	}
+
+	postings.reserve(builders.size());
+	for (auto& [gram, builder] : builders) {
+		if (posting_bytes.size() + builder.bytes.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::length_error("The title postings are larger than 4 GiB.");
+		}
+		postings[gram] = { builder.count, static_cast<uint32_t>(posting_blocks.size()) };
+		uint32_t base = static_cast<uint32_t>(posting_bytes.size());
+		for (const PostingBlock& block : builder.blocks) {
+			posting_blocks.push_back({ block.firstRow, base + block.offset });
+		}
+		posting_bytes.insert(posting_bytes.end(), builder.bytes.begin(), builder.bytes.end());
+		builder = ListBuilder();
+	}
+}
+
+std::string_view TitleSearchIndex::blockHead(size_t block) const {
+	const uint8_t* bytes = dictionary_bytes.data() + dictionary_blocks[block];
+	readVarint(bytes); // Shared length, always 0 here.
+	uint32_t length = readVarint(bytes);
+	return { reinterpret_cast<const char*>(bytes), length };
+}
+
+void TitleSearchIndex::decodeBlock(const PostingList& list, size_t block, std::vector<uint32_t>& rows) const {
+	const PostingBlock& header = posting_blocks[list.firstBlock + block];
+	size_t count = std::min(POSTING_BLOCK, list.count - block * POSTING_BLOCK);
+	const uint8_t* bytes = posting_bytes.data() + header.offset;
+	uint32_t row = header.firstRow;
+	rows.push_back(row);
+	for (size_t i = 1; i < count; ++i) {
+		row += readVarint(bytes);
+		rows.push_back(row);
+	}
+}
+
+void TitleSearchIndex::decodeList(const PostingList& list, std::vector<uint32_t>& rows) const {
+	size_t blocks = (list.count + POSTING_BLOCK - 1) / POSTING_BLOCK;
+	for (size_t block = 0; block < blocks; ++block) {
+		decodeBlock(list, block, rows);
+	}
+}
+
+void TitleSearchIndex::countMatches(const PostingList& list, const std::vector<uint32_t>& candidates, std::vector<uint16_t>& counts) const {
+	const PostingBlock* blocks = posting_blocks.data() + list.firstBlock;
+	size_t blockCount = (list.count + POSTING_BLOCK - 1) / POSTING_BLOCK;
+	auto byFirstRow = [](uint32_t row, const PostingBlock& block) { return row < block.firstRow; };
+	std::vector<uint32_t> rows;
+	std::vector<uint32_t> matches;
+
+	size_t next = 0;
+	size_t block = 0;
+	while (next < candidates.size()) {
+		// The last block starting at or before the next candidate; candidates before the first block are skipped.
+		block = static_cast<size_t>(std::upper_bound(blocks + block, blocks + blockCount, candidates[next], byFirstRow) - blocks);
+		if (block == 0) {
+			next = static_cast<size_t>(std::lower_bound(candidates.begin() + next, candidates.end(), blocks[0].firstRow) - candidates.begin());
+			continue;
+		}
+		--block;
+		size_t last = candidates.size();
+		if (block + 1 < blockCount) {
+			last = static_cast<size_t>(std::lower_bound(candidates.begin() + next, candidates.end(), blocks[block + 1].firstRow) - candidates.begin());
+		}
+
+		rows.clear();
+		matches.clear();
+		decodeBlock(list, block, rows);
+		intersectSorted(candidates.data() + next, last - next, rows.data(), rows.size(), matches);
+		for (uint32_t position : matches) {
+			++counts[next + position];
+		}
+		next = last;
+	}
+}
+
+std::vector<TitleMatch> TitleSearchIndex::autocomplete(std::string_view prefix, size_t limit) const {
+	std::vector<TitleMatch> result;
+	std::string wanted = normalizeTitle(prefix);
+	if (wanted.empty() || limit == 0 || dictionary_blocks.empty()) { return result; }
+
+	// The block before the first one whose head is not below the prefix holds the first key that may match.
+	size_t low = 0, high = dictionary_blocks.size();
+	while (low < high) {
+		size_t middle = (low + high) / 2;
+		if (blockHead(middle) < wanted) { low = middle + 1; }
+		else { high = middle; }
+	}
+	size_t block = low > 0 ? low - 1 : 0;
+
+	std::vector<uint32_t> rows;
+	std::string key;
+	const uint8_t* bytes = dictionary_bytes.data() + dictionary_blocks[block];
+	const uint8_t* end = dictionary_bytes.data() + dictionary_bytes.size();
+	while (bytes < end && rows.size() < limit) {
+		uint32_t shared = readVarint(bytes);
+		uint32_t length = readVarint(bytes);
+		key.resize(shared);
+		key.append(reinterpret_cast<const char*>(bytes), length);
+		bytes += length;
+		uint32_t row = readVarint(bytes);
+
+		if (key.compare(0, wanted.size(), wanted) < 0) { continue; }
+		if (key.compare(0, wanted.size(), wanted) > 0) { break; }
+		// A title can have several words starting with the prefix; it is listed once, at its first key.
+		if (std::find(rows.begin(), rows.end(), row) == rows.end()) { rows.push_back(row); }
+	}
+
+	result.reserve(rows.size());
+	for (uint32_t row : rows) {
+		result.push_back({ movie_ids[row], titles[row], 1.0f });
+	}
+	return result;
+}
+
+std::vector<TitleMatch> TitleSearchIndex::fuzzySearch(std::string_view query, size_t limit, float minScore) const {
+	std::vector<TitleMatch> result;
+	std::vector<uint32_t> grams = trigrams(normalizeTitle(query));
+	if (grams.empty() || limit == 0) { return result; }
+
+	size_t total = grams.size();
+	size_t needed = static_cast<size_t>(std::ceil(std::clamp(minScore, 0.0f, 1.0f) * total - 1e-4f));
+	needed = std::clamp<size_t>(needed, 1, total);
+
+	std::vector<const PostingList*> lists;
+	for (uint32_t gram : grams) {
+		auto it = postings.find(gram);
+		if (it != postings.end()) { lists.push_back(&it->second); }
+	}
+	std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) { return a->count < b->count; });
+
+	// A title with `needed` of the trigrams has one in any total - needed + 1 of the lists. Trigrams that are
+	// in no title have empty lists, which count as the shortest.
+	size_t missing = total - lists.size();
+	size_t scanned = total - needed + 1;
+	if (scanned <= missing) { return result; }
+	scanned = std::min(scanned - missing, lists.size());
+
+	// Each list is sorted, so merging them pairwise takes log2(scanned) passes instead of a full sort.
+	std::vector<uint32_t> rows;
+	std::vector<size_t> runs = { 0 };
+	for (size_t i = 0; i < scanned; ++i) {
+		decodeList(*lists[i], rows);
+		runs.push_back(rows.size());
+	}
+	for (size_t width = 1; width + 1 < runs.size(); width *= 2) {
+		for (size_t run = 0; run + width + 1 < runs.size(); run += 2 * width) {
+			size_t last = std::min(run + 2 * width, runs.size() - 1);
+			std::inplace_merge(rows.begin() + static_cast<std::ptrdiff_t>(runs[run]), rows.begin() + static_cast<std::ptrdiff_t>(runs[run + width]),
+				rows.begin() + static_cast<std::ptrdiff_t>(runs[last]));
+		}
+	}
+	std::vector<uint32_t> candidates;
+	std::vector<uint16_t> counts;
+	for (size_t i = 0; i < rows.size();) {
+		size_t j = i;
+		while (j < rows.size() && rows[j] == rows[i]) { ++j; }
+		candidates.push_back(rows[i]);
+		counts.push_back(static_cast<uint16_t>(j - i));
+		i = j;
+	}
+
+	for (size_t i = scanned; i < lists.size() && !candidates.empty(); ++i) {
+		// Drops the candidates that cannot reach `needed` even if they are in all the remaining lists; every
+		// candidate is in at least one list, so there is nothing to drop while needed <= remaining + 1.
+		size_t remaining = lists.size() - i;
+		if (needed > remaining + 1) {
+			size_t kept = 0;
+			for (size_t c = 0; c < candidates.size(); ++c) {
+				if (counts[c] + remaining >= needed) {
+					candidates[kept] = candidates[c];
+					counts[kept] = counts[c];
+					++kept;
+				}
+			}
+			candidates.resize(kept);
+			counts.resize(kept);
+		}
+		countMatches(*lists[i], candidates, counts);
+	}
+
+	std::vector<std::pair<uint16_t, uint32_t>> matches; // (count, row)
+	for (size_t c = 0; c < candidates.size(); ++c) {
+		if (counts[c] >= needed) { matches.emplace_back(counts[c], candidates[c]); }
+	}
+	auto better = [this](const std::pair<uint16_t, uint32_t>& a, const std::pair<uint16_t, uint32_t>& b) {
+		if (a.first != b.first) { return a.first > b.first; }
+		if (trigram_counts[a.second] != trigram_counts[b.second]) { return trigram_counts[a.second] < trigram_counts[b.second]; }
+		return a.second < b.second;
+	};
+	size_t shown = std::min(limit, matches.size());
+	std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(shown), matches.end(), better);
+
+	result.reserve(shown);
+	for (size_t i = 0; i < shown; ++i) {
+		uint32_t row = matches[i].second;
+		result.push_back({ movie_ids[row], titles[row], static_cast<float>(matches[i].first) / total });
+	}
+	return result;
+}
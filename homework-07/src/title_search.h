@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "movie_catalog.h"
+
+// Lower-case ASCII letters and digits, with every run of other ASCII characters turned into one space and no
+// space at either end. Bytes of multi-byte UTF-8 characters are kept as they are.
+std::string normalizeTitle(std::string_view title);
+
+// Appends to matches the positions in a of the values that are also in b; both must be sorted without
+// duplicates. Returns the number of matches. With SSE2, four values of a are compared with four of b per step.
+size_t intersectSorted(const uint32_t* a, size_t aCount, const uint32_t* b, size_t bCount, std::vector<uint32_t>& matches);
+
+// Rows in increasing order, stored in blocks of POSTING_BLOCK. A block keeps its first row uncompressed, for
+// skipping, and the gaps to the rest as variable-length integers, mostly one byte each.
+constexpr size_t POSTING_BLOCK = 128;
+
+struct PostingBlock {
+	uint32_t firstRow;
+	uint32_t offset; // Start of the gaps in TitleSearchIndex::posting_bytes.
+};
+
+struct PostingList {
+	uint32_t count = 0;
+	uint32_t firstBlock = 0;
+};
+
+struct TitleMatch {
+	int movieId = 0;
+	std::string title;
+	float score = 1.0f; // Share of the query's trigrams found in the title; 1 for autocomplete.
+};
+
+// Title search for the "Browse Movies" use case, built once from a snapshot of the catalog.
+// Autocomplete: every title is entered once per word, starting at that word, into a sorted dictionary. The
+// dictionary is front-coded: in each block of DICTIONARY_BLOCK keys only the first is stored whole, the others
+// as the length shared with the previous key plus the rest, which is what a trie would share, at a fraction
+// of the memory. A prefix is found by a binary search over the first keys of the blocks.
+// Fuzzy search: an inverted index from every trigram of the words ("  star " gives "  s", " st", "sta", "tar",
+// "ar ") to the titles containing it. A title that matches at least a given share of the query's trigrams must
+// appear in one of the shortest lists, so only those are merged into candidates; the long lists are then
+// intersected with the candidates, skipping every block that cannot hold one.
+class TitleSearchIndex {
+private:
+	static constexpr size_t DICTIONARY_BLOCK = 16;
+
+	std::vector<int> movie_ids;
+	std::vector<std::string> titles;
+	std::vector<uint16_t> trigram_counts; // Distinct trigrams per title.
+
+	std::vector<uint8_t> dictionary_bytes;
+	std::vector<uint32_t> dictionary_blocks; // Offset of each block in dictionary_bytes.
+	size_t dictionary_keys = 0;
+
+	std::unordered_map<uint32_t, PostingList> postings; // Keyed by the three bytes of the trigram.
+	std::vector<PostingBlock> posting_blocks;
+	std::vector<uint8_t> posting_bytes;
+
+	void buildDictionary(const std::vector<std::string>& normalized);
+	void buildPostings(const std::vector<std::string>& normalized);
+
+	std::string_view blockHead(size_t block) const;
+	void decodeBlock(const PostingList& list, size_t block, std::vector<uint32_t>& rows) const;
+	void decodeList(const PostingList& list, std::vector<uint32_t>& rows) const;
+
+	// Adds 1 to counts[i] for every candidates[i] that is in list.
+	void countMatches(const PostingList& list, const std::vector<uint32_t>& candidates, std::vector<uint16_t>& counts) const;
+
+public:
+	explicit TitleSearchIndex(const std::vector<Movie>& movies);
+
+	// Distinct trigrams of the padded words of a normalized title, sorted.
+	static std::vector<uint32_t> trigrams(std::string_view normalized);
+
+	// Up to limit titles with a word starting with the prefix, ordered by the text from that word on.
+	std::vector<TitleMatch> autocomplete(std::string_view prefix, size_t limit = 10) const;
+
+	// Up to limit titles sharing at least minScore of the query's trigrams, best first; among equal scores
+	// shorter titles come first, as fewer of their words are left unmatched.
+	std::vector<TitleMatch> fuzzySearch(std::string_view query, size_t limit = 10, float minScore = 0.6f) const;
+
+	size_t size() const { return titles.size(); }
+	size_t dictionaryKeys() const { return dictionary_keys; }
+	size_t trigramCount() const { return postings.size(); }
+	size_t dictionaryBytes() const { return dictionary_bytes.size() + dictionary_blocks.size() * sizeof(uint32_t); }
+	size_t postingBytes() const { return posting_bytes.size() + posting_blocks.size() * sizeof(PostingBlock); }
+};
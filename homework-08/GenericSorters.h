@@ -0,0 +1,301 @@
+// GenericSorters.h - Header-only typed sorting strategies for the MathLib static library.
+
+#ifndef GENERIC_SORTERS_H
+#define GENERIC_SORTERS_H
+
+#include <algorithm>
+#include <cstddef> // Required for size_t
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+#include "MathLib.h"
+
+/**
+ * @brief Key projection that returns the element itself.
+ */
+struct IdentityProjection {
+    template <typename T>
+    constexpr T&& operator()(T&& value) const noexcept { return std::forward<T>(value); }
+};
+
+/**
+ * @brief Compares two elements by their projected keys.
+ *
+ * The projection may be any invocable: a lambda, a function object or a pointer to a data
+ * member or member function (e.g. `&Order::getTotalPrice`).
+ */
+template <typename Projection, typename Compare>
+class ProjectedCompare {
+private:
+    Projection projection;
+    Compare compare;
+
+public:
+    ProjectedCompare(Projection projection, Compare compare) : projection(projection), compare(compare) {}
+
+    template <typename T>
+    bool operator()(const T& left, const T& right) const {
+        return std::invoke(compare, std::invoke(projection, left), std::invoke(projection, right));
+    }
+};
+
+// --- Typed Sorting Algorithm Implementations ---
+//
+// Every algorithm exposes the same static member template:
+//     sort(std::span<T> data, Projection projection = {}, Compare compare = {})
+// It is instantiated for the concrete element type, projection and comparator, so the
+// compiler sees through every call in the inner loops and can inline them.
+
+/**
+ * @brief Typed Bubble Sort. Stable; stops as soon as a pass makes no swaps.
+ */
+struct GenericBubbleSort {
+    static constexpr bool IS_STABLE = true;
+
+    template <typename T, typename Projection = IdentityProjection, typename Compare = std::less<>>
+    static void sort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+        ProjectedCompare<Projection, Compare> less(projection, compare);
+
+        for (size_t i = 0; i + 1 < data.size(); ++i) {
+            bool swapped = false;
+            for (size_t j = 0; j + 1 < data.size() - i; ++j) {
+                if (less(data[j + 1], data[j])) {
+                    std::swap(data[j], data[j + 1]);
+                    swapped = true;
+                }
+            }
+            if (!swapped) { return; }
+        }
+    }
+};
+
+/**
+ * @brief Typed Selection Sort. Unstable; performs at most n - 1 swaps.
+ */
+struct GenericSelectionSort {
+    static constexpr bool IS_STABLE = false;
+
+    template <typename T, typename Projection = IdentityProjection, typename Compare = std::less<>>
+    static void sort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+        ProjectedCompare<Projection, Compare> less(projection, compare);
+
+        for (size_t i = 0; i + 1 < data.size(); ++i) {
+            size_t minIndex = i;
+            for (size_t j = i + 1; j < data.size(); ++j) {
+                if (less(data[j], data[minIndex])) { minIndex = j; }
+            }
+            if (minIndex != i) { std::swap(data[i], data[minIndex]); }
+        }
+    }
+};
+
+/**
+ * @brief Typed Insertion Sort. Stable; runs in linear time on presorted input.
+ */
+struct GenericInsertionSort {
+    static constexpr bool IS_STABLE = true;
+
+    template <typename T, typename Projection = IdentityProjection, typename Compare = std::less<>>
+    static void sort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+        sortWith(data, ProjectedCompare<Projection, Compare>(projection, compare));
+    }
+
+    // Sorts with an already combined comparator; shared with the other algorithms for short ranges.
+    template <typename T, typename Less>
+    static void sortWith(std::span<T> data, const Less& less) {
+        for (size_t i = 1; i < data.size(); ++i) {
+            if (!less(data[i], data[i - 1])) { continue; }
+
+            T key = std::move(data[i]);
+            size_t j = i;
+            do {
+                data[j] = std::move(data[j - 1]);
+                --j;
+            } while (j > 0 && less(key, data[j - 1]));
+            data[j] = std::move(key);
+        }
+    }
+};
+
+/**
+ * @brief Typed Merge Sort. Stable; O(n log n) with a single n-element buffer.
+ *
+ * Short blocks are insertion-sorted first, then merged bottom-up while ping-ponging
+ * between the input and the buffer instead of allocating on every merge.
+ */
+struct GenericMergeSort {
+    static constexpr bool IS_STABLE = true;
+    static constexpr size_t INSERTION_BLOCK = 32;
+
+    template <typename T, typename Projection = IdentityProjection, typename Compare = std::less<>>
+    static void sort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+        ProjectedCompare<Projection, Compare> less(projection, compare);
+        size_t size = data.size();
+
+        for (size_t begin = 0; begin < size; begin += INSERTION_BLOCK) {
+            GenericInsertionSort::sortWith(data.subspan(begin, std::min(INSERTION_BLOCK, size - begin)), less);
+        }
+        if (size <= INSERTION_BLOCK) { return; }
+
+        std::vector<T> buffer(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+        std::span<T> source(buffer);
+        std::span<T> target = data;
+        // The buffer holds the current runs after the move above; each pass merges source into target.
+        for (size_t width = INSERTION_BLOCK; width < size; width *= 2) {
+            for (size_t left = 0; left < size; left += 2 * width) {
+                size_t mid = std::min(left + width, size);
+                size_t right = std::min(left + 2 * width, size);
+                mergeRuns(source, target, left, mid, right, less);
+            }
+            std::swap(source, target);
+        }
+
+        if (source.data() != data.data()) {
+            std::move(source.begin(), source.end(), data.begin());
+        }
+    }
+
+private:
+    template <typename T, typename Less>
+    static void mergeRuns(std::span<T> source, std::span<T> target, size_t left, size_t mid, size_t right, const Less& less) {
+        size_t i = left, j = mid, out = left;
+        while (i < mid && j < right) {
+            // Taking from the right run only when strictly smaller keeps equal keys in order.
+            if (less(source[j], source[i])) { target[out++] = std::move(source[j++]); }
+            else { target[out++] = std::move(source[i++]); }
+        }
+        while (i < mid) { target[out++] = std::move(source[i++]); }
+        while (j < right) { target[out++] = std::move(source[j++]); }
+    }
+};
+
+/**
+ * @brief Typed introspective Quick Sort. Unstable; O(n log n) worst case.
+ *
+ * Uses median-of-three pivots, finishes short ranges with insertion sort and falls back
+ * to heap sort when the recursion gets too deep.
+ */
+struct GenericQuickSort {
+    static constexpr bool IS_STABLE = false;
+    static constexpr size_t INSERTION_THRESHOLD = 24;
+
+    template <typename T, typename Projection = IdentityProjection, typename Compare = std::less<>>
+    static void sort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+        ProjectedCompare<Projection, Compare> less(projection, compare);
+
+        size_t depthLimit = 0;
+        for (size_t size = data.size(); size > 1; size >>= 1) { depthLimit += 2; }
+
+        introSort(data, depthLimit, less);
+    }
+
+private:
+    template <typename T, typename Less>
+    static void introSort(std::span<T> data, size_t depthLimit, const Less& less) {
+        while (data.size() > INSERTION_THRESHOLD) {
+            if (depthLimit-- == 0) {
+                heapSort(data, less);
+                return;
+            }
+
+            size_t split = partition(data, less);
+            // Recurses into the smaller half and loops on the larger one to bound the stack depth.
+            if (split < data.size() - split) {
+                introSort(data.first(split), depthLimit, less);
+                data = data.subspan(split);
+            }
+            else {
+                introSort(data.subspan(split), depthLimit, less);
+                data = data.first(split);
+            }
+        }
+        GenericInsertionSort::sortWith(data, less);
+    }
+
+    // Hoare partition around the median of the first, middle and last elements.
+    // Returns the split point: every element before it is <= every element from it on.
+    template <typename T, typename Less>
+    static size_t partition(std::span<T> data, const Less& less) {
+        size_t last = data.size() - 1;
+        size_t mid = data.size() / 2;
+        if (less(data[mid], data[0])) { std::swap(data[mid], data[0]); }
+        if (less(data[last], data[0])) { std::swap(data[last], data[0]); }
+        if (less(data[last], data[mid])) { std::swap(data[last], data[mid]); }
+        T pivot = data[mid];
+
+        size_t i = 0, j = last;
+        while (true) {
+            while (less(data[i], pivot)) { ++i; }
+            while (less(pivot, data[j])) { --j; }
+            if (i >= j) { return j + 1; }
+            std::swap(data[i++], data[j--]);
+        }
+    }
+
+    template <typename T, typename Less>
+    static void heapSort(std::span<T> data, const Less& less) {
+        for (size_t start = data.size() / 2; start-- > 0;) { siftDown(data, start, data.size(), less); }
+        for (size_t end = data.size(); end-- > 1;) {
+            std::swap(data[0], data[end]);
+            siftDown(data, 0, end, less);
+        }
+    }
+
+    template <typename T, typename Less>
+    static void siftDown(std::span<T> data, size_t root, size_t end, const Less& less) {
+        while (2 * root + 1 < end) {
+            size_t child = 2 * root + 1;
+            if (child + 1 < end && less(data[child], data[child + 1])) { ++child; }
+            if (!less(data[root], data[child])) { return; }
+            std::swap(data[root], data[child]);
+            root = child;
+        }
+    }
+};
+
+// --------------------------------------------------
+
+/**
+ * @brief Returns the permutation that sorts the data, without moving the data itself.
+ *
+ * `data[result[0]]`, `data[result[1]]`, ... are in sorted order. With a stable algorithm
+ * (the default, GenericMergeSort) equal keys keep their original relative order.
+ * @tparam Algorithm The typed sorting algorithm used to order the indices.
+ * @param data The elements to rank; they are only read.
+ * @param projection The key projection applied to each element.
+ * @param compare The comparator applied to the projected keys.
+ * @return The sorting permutation as a vector of indices into data.
+ */
+template <typename Algorithm = GenericMergeSort, typename T,
+          typename Projection = IdentityProjection, typename Compare = std::less<>>
+std::vector<size_t> argsort(std::span<T> data, Projection projection = {}, Compare compare = {}) {
+    std::vector<size_t> indices(data.size());
+    std::iota(indices.begin(), indices.end(), size_t{ 0 });
+
+    auto indexProjection = [&data, &projection](size_t index) -> decltype(auto) {
+        return std::invoke(projection, data[index]);
+    };
+    Algorithm::sort(std::span<size_t>(indices), indexProjection, compare);
+
+    return indices;
+}
+
+/**
+ * @brief Exposes a typed sorting algorithm through the ISorter interface.
+ *
+ * Allows the typed algorithms to be passed to MathLib::sortArray like any other strategy.
+ * Operation counters are not collected for adapted sorters.
+ */
+template <typename Algorithm>
+class SorterAdapter : public ISorter {
+public:
+    void sort(double arr[], size_t size) override {
+        stats = SortStats{};
+        Algorithm::sort(std::span<double>(arr, size));
+    }
+};
+
+#endif // GENERIC_SORTERS_H
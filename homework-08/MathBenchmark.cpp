@@ -0,0 +1,225 @@
+// MathBenchmark.cpp - A console application that benchmarks selected MathLib functions.
+//
+// Usage: MathBenchmark [element count]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+#include "MathLib.h"
+
+// Fixed seed so that every run benchmarks exactly the same inputs.
+const uint64_t BENCHMARK_SEED = 20240601;
+
+// Helper function to create a border for section titles to improve readability.
+void titleBorder(const std::string& TITLE) {
+    for (size_t i = 0; i < TITLE.size(); ++i) {
+        std::cout << "-";
+    }
+    std::cout << std::endl << std::endl;
+}
+
+// Runs the body once and returns the elapsed wall-clock time in nanoseconds.
+double measureNanoseconds(const std::function<void()>& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Prints one result row: name, time per operation and a checksum proving all variants agree.
+void printRow(const std::string& name, double totalNs, size_t operations, uint64_t checksum) {
+    std::cout << std::left << std::setw(32) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(2) << totalNs / operations << " ns/op"
+              << "   checksum: " << checksum << std::endl;
+}
+
+// The original signed Euclidean loop of MathLib::gcd, kept as a baseline.
+int euclideanGcd(int number1, int number2) {
+    while (number2 != 0) {
+        int temp = number2;
+        number2 = number1 % number2;
+        number1 = temp;
+    }
+
+    return number1 < 0 ? -number1 : number1;
+}
+
+// 64-bit version of the same Euclidean loop.
+uint64_t euclideanGcd64(uint64_t number1, uint64_t number2) {
+    while (number2 != 0) {
+        uint64_t temp = number2;
+        number2 = number1 % number2;
+        number1 = temp;
+    }
+
+    return number1;
+}
+
+// Compares scalar GCD implementations on random 32-bit and 64-bit pairs.
+void benchmarkScalarGcd(size_t pairCount) {
+    const std::string TITLE = "--- Scalar GCD (" + std::to_string(pairCount) + " pairs) ---";
+    std::cout << TITLE << std::endl;
+
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::uniform_int_distribution<int> intDistribution(1, std::numeric_limits<int>::max());
+    std::vector<int> ints(2 * pairCount);
+    std::vector<uint64_t> wides(2 * pairCount);
+    for (auto& value : ints) { value = intDistribution(generator); }
+    for (auto& value : wides) { value = generator() | 1; }
+
+    uint64_t checksum = 0;
+    double ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += euclideanGcd(ints[2 * i], ints[2 * i + 1]); }
+    });
+    printRow("Euclidean (int, baseline)", ns, pairCount, checksum);
+
+    checksum = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += MathLib::gcd(ints[2 * i], ints[2 * i + 1]); }
+    });
+    printRow("MathLib::gcd (int)", ns, pairCount, checksum);
+
+    checksum = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += std::gcd(ints[2 * i], ints[2 * i + 1]); }
+    });
+    printRow("std::gcd (int)", ns, pairCount, checksum);
+
+    std::cout << std::endl;
+
+    checksum = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += euclideanGcd64(wides[2 * i], wides[2 * i + 1]); }
+    });
+    printRow("Euclidean (uint64_t, baseline)", ns, pairCount, checksum);
+
+    checksum = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += MathLib::binaryGcd(wides[2 * i], wides[2 * i + 1]); }
+    });
+    printRow("MathLib::binaryGcd (uint64_t)", ns, pairCount, checksum);
+
+    checksum = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < pairCount; ++i) { checksum += std::gcd(wides[2 * i], wides[2 * i + 1]); }
+    });
+    printRow("std::gcd (uint64_t)", ns, pairCount, checksum);
+
+    titleBorder(TITLE);
+}
+
+// Compares batched GCD over whole arrays against a serial std::gcd loop.
+void benchmarkBatchedGcd(size_t size) {
+    const std::string TITLE = "--- Batched GCD (" + std::to_string(size) + " elements) ---";
+    std::cout << TITLE << std::endl;
+
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::vector<uint64_t> first(size), second(size), result(size);
+    for (auto& value : first) { value = generator(); }
+    for (auto& value : second) { value = generator(); }
+
+    double ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < size; ++i) { result[i] = std::gcd(first[i], second[i]); }
+    });
+    printRow("std::gcd loop", ns, size, std::accumulate(result.begin(), result.end(), uint64_t{ 0 }));
+
+    ns = measureNanoseconds([&] { MathLib::gcdArray(first.data(), second.data(), result.data(), size); });
+    printRow("MathLib::gcdArray", ns, size, std::accumulate(result.begin(), result.end(), uint64_t{ 0 }));
+
+    // Multiples of a common factor, so the reduction cannot stop early.
+    for (auto& value : first) { value = (value % 1000000 + 1) * 7919; }
+
+    uint64_t reduced = 0;
+    ns = measureNanoseconds([&] {
+        for (size_t i = 0; i < size; ++i) { reduced = std::gcd(reduced, first[i]); }
+    });
+    printRow("std::gcd fold", ns, size, reduced);
+
+    ns = measureNanoseconds([&] { reduced = MathLib::gcdReduce(first.data(), size); });
+    printRow("MathLib::gcdReduce", ns, size, reduced);
+
+    titleBorder(TITLE);
+}
+
+// Prints one selection result row: name, time per query in milliseconds and the value found.
+void printQueryRow(const std::string& name, double totalNs, double value) {
+    std::cout << std::left << std::setw(32) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3) << totalNs / 1e6 << " ms"
+              << "   value: " << std::setprecision(4) << value << std::endl;
+}
+
+// Compares the selection functions against sorting the whole array and indexing into it.
+void benchmarkSelection(size_t size) {
+    const std::string TITLE = "--- Selection (" + std::to_string(size) + " elements) ---";
+    std::cout << TITLE << std::endl;
+
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::uniform_real_distribution<double> values(0.0, 1e6);
+    std::vector<double> input(size);
+    for (auto& value : input) { value = values(generator); }
+
+    // Every query works on a fresh copy, since selection reorders the array; the copy is not timed.
+    std::vector<double> work;
+    auto timeQuery = [&](const std::string& name, const std::function<double()>& query) {
+        work = input;
+        double result = 0.0;
+        double ns = measureNanoseconds([&] { result = query(); });
+        printQueryRow(name, ns, result);
+    };
+
+    timeQuery("sort + index (median)", [&] {
+        std::sort(work.begin(), work.end());
+        return size % 2 != 0 ? work[size / 2] : (work[size / 2 - 1] + work[size / 2]) / 2.0;
+    });
+    timeQuery("std::nth_element (median)", [&] {
+        std::nth_element(work.begin(), work.begin() + size / 2, work.end());
+        return work[size / 2];
+    });
+    timeQuery("MathLib::median", [&] { return MathLib::median(work.data(), size); });
+
+    std::cout << std::endl;
+
+    timeQuery("sort + index (p99)", [&] {
+        std::sort(work.begin(), work.end());
+        double rank = 0.99 * (size - 1);
+        size_t lower = static_cast<size_t>(rank);
+        return lower + 1 < size ? work[lower] + (work[lower + 1] - work[lower]) * (rank - lower) : work[lower];
+    });
+    timeQuery("MathLib::percentile (p99)", [&] { return MathLib::percentile(work.data(), size, 99.0); });
+
+    std::cout << std::endl;
+
+    const size_t K = 10;
+    std::vector<double> top(K);
+    timeQuery("sort + take (top 10)", [&] {
+        std::sort(work.begin(), work.end(), std::greater<double>());
+        return work[K - 1];
+    });
+    timeQuery("MathLib::topK (top 10)", [&] {
+        MathLib::topK(work.data(), size, K, top.data());
+        return top[K - 1];
+    });
+
+    titleBorder(TITLE);
+}
+
+int main(int argc, char* argv[]) {
+    size_t size = argc > 1 ? std::stoull(argv[1]) : 10000000;
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl << std::endl;
+
+    benchmarkScalarGcd(size);
+    benchmarkBatchedGcd(size);
+    benchmarkSelection(size);
+
+    return 0;
+}
@@ -4,7 +4,15 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <vector>
 #include "MathLib.h"
+#include "GenericSorters.h"
+
+// A sample record used to demonstrate the typed sorters.
+struct Product {
+    std::string name;
+    double price;
+};
 
 // Helper function to create a border for section titles to improve readability.
 void titleBorder(const std::string& TITLE) {
@@ -136,12 +144,14 @@ void arrayOperations() {
         std::cout << "Min value: " << MathLib::findMin(arr.get(), arraySize) << std::endl;
         std::cout << "Sum: " << MathLib::calculateSum(arr.get(), arraySize) << std::endl;
         std::cout << "Average: " << MathLib::calculateAverage(arr.get(), arraySize) << std::endl;
+        std::cout << "Median: " << MathLib::median(arr.get(), arraySize) << std::endl;
 
         std::cout << "\nChoose sorting algorithm:" << std::endl;
         std::cout << "1. Bubble Sort" << std::endl;
         std::cout << "2. Selection Sort" << std::endl;
         std::cout << "3. Insertion Sort" << std::endl;
         std::cout << "4. Merge Sort" << std::endl;
+        std::cout << "5. Merge Sort (adaptive, for nearly sorted data)" << std::endl;
 
         int sortChoice = getIntInput("Your choice: ");
         std::unique_ptr<ISorter> sorter;
@@ -150,6 +160,7 @@ void arrayOperations() {
         case 2: sorter = std::make_unique<SelectionSorter>(); break;
         case 3: sorter = std::make_unique<InsertionSorter>(); break;
         case 4: sorter = std::make_unique<MergeSorter>(); break;
+        case 5: sorter = std::make_unique<MergeSorter>(MergeSorter::Mode::Natural); break;
         default:
             std::cout << "Invalid choice. Skipping sort." << std::endl;
             return;
@@ -183,7 +194,12 @@ void integerFunctions() {
 
     int gcdNum1 = getIntInput("\nEnter first integer for GCD: ");
     int gcdNum2 = getIntInput("Enter second integer for GCD: ");
-    std::cout << "GCD of " << gcdNum1 << " and " << gcdNum2 << ": " << MathLib::gcd(gcdNum1, gcdNum2) << std::endl;
+    try {
+        std::cout << "GCD of " << gcdNum1 << " and " << gcdNum2 << ": " << MathLib::gcd(gcdNum1, gcdNum2) << std::endl;
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
 
     int fibNum = getIntInput("\nEnter index for Fibonacci number: ");
     try {
@@ -255,6 +271,8 @@ void demonstrateAllFunctions() {
         std::cout << "isPrime(7): " << (MathLib::isPrime(7) ? "true" : "false") << std::endl;
         std::cout << "isPrime(10): " << (MathLib::isPrime(10) ? "true" : "false") << std::endl;
         std::cout << "gcd(48, 18): " << MathLib::gcd(48, 18) << std::endl;
+        std::cout << "binaryGcd(3378742128, 2305843009): " << MathLib::binaryGcd(3378742128ULL, 2305843009ULL) << std::endl;
+        std::cout << "lcm(21, 6): " << MathLib::lcm(21, 6) << std::endl;
         std::cout << "fibonacci(10): " << MathLib::fibonacci(10) << std::endl;
         titleBorder(TITLE);
     }
@@ -274,6 +292,12 @@ void demonstrateAllFunctions() {
         std::cout << "Min value: " << MathLib::findMin(demoArr, demoSize) << std::endl;
         std::cout << "Sum: " << MathLib::calculateSum(demoArr, demoSize) << std::endl;
         std::cout << "Average: " << MathLib::calculateAverage(demoArr, demoSize) << std::endl;
+
+        double topTwo[2];
+        MathLib::topK(demoArr, demoSize, 2, topTwo);
+        std::cout << "Top 2 values: " << topTwo[0] << ", " << topTwo[1] << std::endl;
+        std::cout << "Median: " << MathLib::median(demoArr, demoSize) << std::endl;
+        std::cout << "90th percentile: " << MathLib::percentile(demoArr, demoSize, 90.0) << std::endl;
         titleBorder(TITLE);
 
         // Demonstrating the Strategy Pattern with different sorters
@@ -293,7 +317,32 @@ void demonstrateAllFunctions() {
         MergeSorter mergeSorter;
         demonstrateSorting(mergeSorter, "Merge Sort");
 
+        MergeSorter naturalMergeSorter(MergeSorter::Mode::Natural);
+        demonstrateSorting(naturalMergeSorter, "Merge Sort (adaptive)");
+
+        SorterAdapter<GenericQuickSort> quickSorter;
+        demonstrateSorting(quickSorter, "Quick Sort (typed, via adapter)");
+
         titleBorder(SUB_TITLE);
+
+        // Demonstrating the typed sorters on records, sorted by a projected key
+
+        std::string TYPED_TITLE = "--- Sorting records with typed sorters ---";
+        std::cout << TYPED_TITLE << std::endl;
+
+        std::vector<Product> products = { { "Keyboard", 49.99 }, { "Monitor", 189.0 }, { "Mouse", 19.5 }, { "Cable", 4.99 } };
+
+        std::vector<size_t> order = argsort(std::span(products), &Product::price);
+        std::cout << "Argsort by price (indices): ";
+        for (size_t index : order) { std::cout << index << " "; }
+        std::cout << std::endl;
+
+        GenericMergeSort::sort(std::span(products), &Product::price, std::greater<>());
+        std::cout << "Sorted by price, descending: ";
+        for (const auto& product : products) { std::cout << product.name << " (" << product.price << ") "; }
+        std::cout << std::endl;
+
+        titleBorder(TYPED_TITLE);
     }
     titleBorder(G_TITLE);
 }
@@ -5,10 +5,66 @@
 #include <stdexcept>
 #include <algorithm>
 #include <vector>
+#include <bit>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <functional>
+#include <cmath>
+#include <cstddef>
 
 // A constant used for floating-point comparisons to zero.
 const double EPSILON = 1e-15;
 
+// Sorters count comparisons and moves only when the library is compiled with MATHLIB_SORT_STATS.
+#ifdef MATHLIB_SORT_STATS
+constexpr bool SORT_STATS_ENABLED = true;
+#else
+constexpr bool SORT_STATS_ENABLED = false;
+#endif
+
+// Clears the counters at the start of a sort() call.
+static inline void resetStats(SortStats& stats) {
+    stats = SortStats{};
+    stats.collected = SORT_STATS_ENABLED;
+}
+
+// Records one comparison and passes its result through.
+static inline bool compared(SortStats& stats, bool result) {
+    if constexpr (SORT_STATS_ENABLED) { ++stats.comparisons; }
+    return result;
+}
+
+// Records the given number of element moves.
+static inline void countMoves(SortStats& stats, size_t count) {
+    if constexpr (SORT_STATS_ENABLED) { stats.moves += count; }
+}
+
+// Arrays smaller than this are processed on the calling thread; spawning threads costs more than it saves.
+const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+// Splits [0, size) into one contiguous chunk per hardware thread and runs body(begin, end) on each.
+// The calling thread processes the first chunk itself.
+static void runInParallel(size_t size, const std::function<void(size_t, size_t)>& body) {
+    size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (size < PARALLEL_THRESHOLD || threadCount == 1) {
+        body(0, size);
+        return;
+    }
+
+    size_t chunkSize = (size + threadCount - 1) / threadCount;
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (size_t begin = chunkSize; begin < size; begin += chunkSize) {
+        workers.emplace_back(body, begin, std::min(begin + chunkSize, size));
+    }
+    body(0, std::min(chunkSize, size));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
 // --- Basic Arithmetic Operations ---
 
 double MathLib::add(double addend1, double addend2) { return addend1 + addend2; }
@@ -84,14 +140,58 @@ bool MathLib::isPrime(int number) {
 }
 
 int MathLib::gcd(int number1, int number2) {
-    // Implements the Euclidean algorithm to find the greatest common divisor.
-    while (number2 != 0) {
-        int temp = number2;
-        number2 = number1 % number2;
-        number1 = temp;
+    // Implements the Euclidean algorithm to find the greatest common divisor. For 32-bit operands a
+    // hardware division is cheaper than the shift-and-subtract loop of binaryGcd. It runs on the
+    // magnitudes, so INT_MIN needs no special handling and INT_MIN % -1 cannot occur.
+    uint32_t magnitude1 = number1 < 0 ? 0u - static_cast<uint32_t>(number1) : static_cast<uint32_t>(number1);
+    uint32_t magnitude2 = number2 < 0 ? 0u - static_cast<uint32_t>(number2) : static_cast<uint32_t>(number2);
+    while (magnitude2 != 0) {
+        uint32_t temp = magnitude2;
+        magnitude2 = magnitude1 % magnitude2;
+        magnitude1 = temp;
+    }
+
+    // Only gcd(INT_MIN, 0) and gcd(INT_MIN, INT_MIN) are 2^31, one more than INT_MAX.
+    if (magnitude1 > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("GCD does not fit into an int.");
+    }
+
+    return static_cast<int>(magnitude1);
+}
+
+uint64_t MathLib::binaryGcd(uint64_t number1, uint64_t number2) {
+    if (number1 == 0) { return number2; }
+    if (number2 == 0) { return number1; }
+
+    // Implements Stein's algorithm: the common power of two is factored out once, then the odd
+    // values are reduced by subtraction instead of division. The trailing zeros of the difference
+    // are counted before taking the minimum so the two steps do not wait on each other.
+    int shiftA = std::countr_zero(number1);
+    int shiftB = std::countr_zero(number2);
+    int commonShift = std::min(shiftA, shiftB);
+    number2 >>= shiftB;
+
+    while (number1 != 0) {
+        number1 >>= shiftA;
+        uint64_t difference = number2 - number1;
+        shiftA = std::countr_zero(difference);
+        uint64_t absDifference = number1 > number2 ? number1 - number2 : difference;
+        number2 = std::min(number1, number2);
+        number1 = absDifference;
+    }
+
+    return number2 << commonShift;
+}
+
+uint64_t MathLib::lcm(uint64_t number1, uint64_t number2) {
+    if (number1 == 0 || number2 == 0) { return 0; }
+
+    uint64_t quotient = number1 / MathLib::binaryGcd(number1, number2);
+    if (quotient > std::numeric_limits<uint64_t>::max() / number2) {
+        throw std::runtime_error("LCM does not fit into a 64-bit unsigned integer.");
     }
 
-    return MathLib::absoluteValue(number1);
+    return quotient * number2;
 }
 
 // --- Array Operations ---
@@ -133,53 +233,100 @@ double MathLib::calculateAverage(const double arr[], size_t size) {
     return MathLib::calculateSum(arr, size) / size;
 }
 
+void MathLib::gcdArray(const uint64_t first[], const uint64_t second[], uint64_t result[], size_t size) {
+    runInParallel(size, [first, second, result](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = MathLib::binaryGcd(first[i], second[i]);
+        }
+    });
+}
+
+uint64_t MathLib::gcdReduce(const uint64_t arr[], size_t size) {
+    std::atomic<uint64_t> result{ 0 };
+    std::atomic<bool> reachedOne{ false };
+
+    // Once any chunk reaches 1 the overall answer is known, so the remaining chunks stop scanning.
+    runInParallel(size, [arr, &result, &reachedOne](size_t begin, size_t end) {
+        uint64_t chunkGcd = 0;
+        for (size_t i = begin; i < end; ++i) {
+            chunkGcd = MathLib::binaryGcd(chunkGcd, arr[i]);
+            if (chunkGcd == 1) {
+                reachedOne.store(true, std::memory_order_relaxed);
+                break;
+            }
+            if ((i & 1023) == 0 && reachedOne.load(std::memory_order_relaxed)) { break; }
+        }
+
+        uint64_t current = result.load();
+        while (!result.compare_exchange_weak(current, MathLib::binaryGcd(current, chunkGcd))) {}
+    });
+
+    return reachedOne.load() ? 1 : result.load();
+}
+
 // --- Sorting Strategy Implementations ---
 
 void BubbleSorter::sort(double arr[], size_t size) {
+    resetStats(stats);
+
     // Compares adjacent elements and swaps them if they are in the wrong order.
     // Repeats passes until no more swaps are needed.
     for (size_t i = 0; i < size; ++i) {
         for (size_t j = 0; j < size - i - 1; ++j) {
-            if (arr[j] > arr[j + 1]) {
+            if (compared(stats, arr[j] > arr[j + 1])) {
                 double temp = arr[j];
                 arr[j] = arr[j + 1];
                 arr[j + 1] = temp;
+                countMoves(stats, 3);
             }
         }
     }
 }
 
 void SelectionSorter::sort(double arr[], size_t size) {
+    resetStats(stats);
+
     // Finds the minimum element from the unsorted part and places it at the beginning.
     for (size_t i = 0; i < size - 1; ++i) {
         size_t min_idx = i;
         for (size_t j = i + 1; j < size; ++j) {
-            if (arr[j] < arr[min_idx]) {
+            if (compared(stats, arr[j] < arr[min_idx])) {
                 min_idx = j;
             }
         }
         double temp = arr[min_idx];
         arr[min_idx] = arr[i];
         arr[i] = temp;
+        countMoves(stats, 3);
     }
 }
 
 void InsertionSorter::sort(double arr[], size_t size) {
+    resetStats(stats);
+
     // Builds the final sorted array one item at a time.
     for (size_t i = 1; i < size; ++i) {
         double key = arr[i];
         size_t j = i - 1;
-        while (j < size && arr[j] > key) {
+        while (j < size && compared(stats, arr[j] > key)) {
             arr[j + 1] = arr[j];
+            countMoves(stats, 1);
             j = j - 1;
         }
         arr[j + 1] = key;
+        countMoves(stats, 2);
     }
 }
 
 void MergeSorter::sort(double arr[], size_t size) {
+    resetStats(stats);
     if (size <= 1) { return; }
 
+    if (mode == Mode::Natural) {
+        naturalSort(arr, size);
+        return;
+    }
+
     size_t left = 0;
     size_t right = size - 1;
 
@@ -203,12 +350,13 @@ void MergeSorter::merge(double arr[], size_t left, size_t mid, size_t right) {
 
     for (size_t i = 0; i < subArrayOne; i++) { leftArray[i] = arr[left + i]; }
     for (size_t j = 0; j < subArrayTwo; j++) { rightArray[j] = arr[mid + 1 + j]; }
+    countMoves(stats, 2 * (subArrayOne + subArrayTwo));
 
     size_t indexOfSubArrayOne = 0, indexOfSubArrayTwo = 0;
     size_t indexOfMergedArray = left;
 
     while (indexOfSubArrayOne < subArrayOne && indexOfSubArrayTwo < subArrayTwo) {
-        if (leftArray[indexOfSubArrayOne] <= rightArray[indexOfSubArrayTwo]) {
+        if (compared(stats, leftArray[indexOfSubArrayOne] <= rightArray[indexOfSubArrayTwo])) {
             arr[indexOfMergedArray] = leftArray[indexOfSubArrayOne];
             indexOfSubArrayOne++;
         }
@@ -235,12 +383,411 @@ void MergeSorter::merge(double arr[], size_t left, size_t mid, size_t right) {
     delete[] rightArray;
 }
 
+// --- Natural (TimSort-style) Merge Sort ---
+
+// Arrays shorter than this are sorted with a single binary insertion sort.
+const size_t MIN_MERGE = 64;
+
+// Initial number of consecutive wins by one run before the merge switches to galloping.
+const size_t MIN_GALLOP = 7;
+
+// Chooses a minimum run length in [32, 64] so that n / minRun is close to, but not above, a power of two.
+static size_t computeMinRun(size_t size) {
+    size_t remainder = 0;
+    while (size >= MIN_MERGE) {
+        remainder |= size & 1;
+        size >>= 1;
+    }
+    return size + remainder;
+}
+
+void MergeSorter::naturalSort(double arr[], size_t size) {
+    if (size < MIN_MERGE) {
+        size_t runLength = countRunAndMakeAscending(arr, 0, size);
+        binaryInsertionSort(arr, 0, size, runLength);
+        return;
+    }
+
+    minGallop = MIN_GALLOP;
+    runs.clear();
+    size_t minRun = computeMinRun(size);
+
+    // Walks the array once, picking up existing runs (short ones are extended to minRun)
+    // and merging pending runs whenever their lengths stop shrinking geometrically.
+    for (size_t low = 0; low < size;) {
+        size_t runLength = countRunAndMakeAscending(arr, low, size);
+        if (runLength < minRun) {
+            size_t forced = std::min(minRun, size - low);
+            binaryInsertionSort(arr, low, low + forced, low + runLength);
+            runLength = forced;
+        }
+
+        runs.push_back({ low, runLength });
+        mergeCollapse(arr);
+        low += runLength;
+    }
+
+    mergeForceCollapse(arr);
+}
+
+size_t MergeSorter::countRunAndMakeAscending(double arr[], size_t low, size_t high) {
+    size_t runHigh = low + 1;
+    if (runHigh == high) { return 1; }
+
+    // Only strictly descending runs are reversed, so equal elements never change their order.
+    if (compared(stats, arr[runHigh] < arr[low])) {
+        ++runHigh;
+        while (runHigh < high && compared(stats, arr[runHigh] < arr[runHigh - 1])) { ++runHigh; }
+        std::reverse(arr + low, arr + runHigh);
+        countMoves(stats, runHigh - low);
+    }
+    else {
+        ++runHigh;
+        while (runHigh < high && !compared(stats, arr[runHigh] < arr[runHigh - 1])) { ++runHigh; }
+    }
+
+    return runHigh - low;
+}
+
+void MergeSorter::binaryInsertionSort(double arr[], size_t low, size_t high, size_t start) {
+    // arr[low, start) is already sorted; each next element is placed after any equal ones.
+    for (size_t i = start; i < high; ++i) {
+        double pivot = arr[i];
+        size_t left = low, right = i;
+        while (left < right) {
+            size_t mid = left + (right - left) / 2;
+            if (compared(stats, pivot < arr[mid])) { right = mid; }
+            else { left = mid + 1; }
+        }
+
+        std::move_backward(arr + left, arr + i, arr + i + 1);
+        arr[left] = pivot;
+        countMoves(stats, i - left + 2);
+    }
+}
+
+void MergeSorter::mergeCollapse(double arr[]) {
+    // Keeps the pending run lengths decreasing faster than the Fibonacci numbers, which bounds
+    // the stack depth and keeps merges balanced.
+    while (runs.size() > 1) {
+        size_t n = runs.size() - 2;
+        if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length) ||
+            (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length)) {
+            if (runs[n - 1].length < runs[n + 1].length) { --n; }
+        }
+        else if (runs[n].length > runs[n + 1].length) {
+            break;
+        }
+        mergeAt(arr, n);
+    }
+}
+
+void MergeSorter::mergeForceCollapse(double arr[]) {
+    while (runs.size() > 1) {
+        size_t n = runs.size() - 2;
+        if (n > 0 && runs[n - 1].length < runs[n + 1].length) { --n; }
+        mergeAt(arr, n);
+    }
+}
+
+void MergeSorter::mergeAt(double arr[], size_t index) {
+    size_t base1 = runs[index].start, length1 = runs[index].length;
+    size_t base2 = runs[index + 1].start, length2 = runs[index + 1].length;
+
+    runs[index].length = length1 + length2;
+    runs.erase(runs.begin() + index + 1);
+
+    // Elements of the first run that are <= the head of the second run are already in place.
+    size_t skipped = gallop(arr[base2], arr + base1, length1, 0, true);
+    base1 += skipped;
+    length1 -= skipped;
+    if (length1 == 0) { return; }
+
+    // Elements of the second run that are >= the tail of the first run are already in place too.
+    length2 = gallop(arr[base1 + length1 - 1], arr + base2, length2, length2 - 1, false);
+    if (length2 == 0) { return; }
+
+    // Copies the shorter run into the buffer and merges towards the side it came from.
+    if (length1 <= length2) { mergeLow(arr, base1, length1, base2, length2); }
+    else { mergeHigh(arr, base1, length1, base2, length2); }
+}
+
+void MergeSorter::mergeLow(double arr[], size_t base1, size_t length1, size_t base2, size_t length2) {
+    buffer.assign(arr + base1, arr + base1 + length1);
+    countMoves(stats, length1);
+
+    size_t cursor1 = 0;                   // Next element of the first run (in the buffer).
+    size_t cursor2 = base2;               // Next element of the second run (in place).
+    size_t end2 = base2 + length2;
+    size_t dest = base1;
+
+    while (cursor1 < length1 && cursor2 < end2) {
+        // One element at a time until one run wins minGallop times in a row.
+        size_t count1 = 0, count2 = 0;
+        do {
+            if (compared(stats, arr[cursor2] < buffer[cursor1])) {
+                arr[dest++] = arr[cursor2++];
+                ++count2;
+                count1 = 0;
+            }
+            else {
+                arr[dest++] = buffer[cursor1++];
+                ++count1;
+                count2 = 0;
+            }
+            countMoves(stats, 1);
+        } while (cursor1 < length1 && cursor2 < end2 && (count1 | count2) < minGallop);
+
+        // Galloping: copies whole stretches found by exponential search while they stay long.
+        while (cursor1 < length1 && cursor2 < end2) {
+            count1 = gallop(arr[cursor2], buffer.data() + cursor1, length1 - cursor1, 0, true);
+            std::copy(buffer.data() + cursor1, buffer.data() + cursor1 + count1, arr + dest);
+            dest += count1;
+            cursor1 += count1;
+            countMoves(stats, count1);
+            if (cursor1 == length1) { break; }
+
+            count2 = gallop(buffer[cursor1], arr + cursor2, end2 - cursor2, 0, false);
+            std::copy(arr + cursor2, arr + cursor2 + count2, arr + dest);
+            dest += count2;
+            cursor2 += count2;
+            countMoves(stats, count2);
+            if (cursor2 == end2) { break; }
+
+            if (minGallop > 1) { --minGallop; }
+            if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) { break; }
+        }
+        minGallop += 2; // Penalizes leaving galloping mode.
+    }
+
+    // Whatever is left of the second run is already in place.
+    std::copy(buffer.data() + cursor1, buffer.data() + length1, arr + dest);
+    countMoves(stats, length1 - cursor1);
+}
+
+void MergeSorter::mergeHigh(double arr[], size_t base1, size_t length1, size_t base2, size_t length2) {
+    buffer.assign(arr + base2, arr + base2 + length2);
+    countMoves(stats, length2);
+
+    // Merges from the right end: remaining1 elements of the first run (in place) and
+    // remaining2 elements of the second run (in the buffer) are still to be placed.
+    size_t remaining1 = length1;
+    size_t remaining2 = length2;
+
+    while (remaining1 > 0 && remaining2 > 0) {
+        size_t count1 = 0, count2 = 0;
+        do {
+            size_t dest = base1 + remaining1 + remaining2 - 1;
+            if (compared(stats, buffer[remaining2 - 1] < arr[base1 + remaining1 - 1])) {
+                arr[dest] = arr[base1 + --remaining1];
+                ++count1;
+                count2 = 0;
+            }
+            else {
+                arr[dest] = buffer[--remaining2];
+                ++count2;
+                count1 = 0;
+            }
+            countMoves(stats, 1);
+        } while (remaining1 > 0 && remaining2 > 0 && (count1 | count2) < minGallop);
+
+        while (remaining1 > 0 && remaining2 > 0) {
+            size_t keep1 = gallop(buffer[remaining2 - 1], arr + base1, remaining1, remaining1 - 1, true);
+            count1 = remaining1 - keep1;
+            std::move_backward(arr + base1 + keep1, arr + base1 + remaining1, arr + base1 + remaining1 + remaining2);
+            remaining1 = keep1;
+            countMoves(stats, count1);
+            if (remaining1 == 0) { break; }
+
+            size_t keep2 = gallop(arr[base1 + remaining1 - 1], buffer.data(), remaining2, remaining2 - 1, false);
+            count2 = remaining2 - keep2;
+            std::copy_backward(buffer.data() + keep2, buffer.data() + remaining2, arr + base1 + remaining1 + remaining2);
+            remaining2 = keep2;
+            countMoves(stats, count2);
+            if (remaining2 == 0) { break; }
+
+            if (minGallop > 1) { --minGallop; }
+            if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) { break; }
+        }
+        minGallop += 2;
+    }
+
+    // Whatever is left of the first run is already in place.
+    std::copy(buffer.data(), buffer.data() + remaining2, arr + base1);
+    countMoves(stats, remaining2);
+}
+
+size_t MergeSorter::gallop(double key, const double arr[], size_t length, size_t hint, bool afterEqual) {
+    // Returns how many leading elements of the sorted arr[0, length) go before key:
+    // elements < key, or elements <= key when afterEqual is set. Probes outward from hint
+    // with exponentially growing steps, then finishes with a binary search.
+    auto goesBefore = [&](double value) {
+        return afterEqual ? !compared(stats, key < value) : compared(stats, value < key);
+    };
+
+    size_t low = 0, high = length;
+    if (goesBefore(arr[hint])) {
+        low = hint + 1;
+        for (size_t step = 1; hint + step < length; step *= 2) {
+            if (!goesBefore(arr[hint + step])) {
+                high = hint + step;
+                break;
+            }
+            low = hint + step + 1;
+        }
+    }
+    else {
+        high = hint;
+        for (size_t step = 1; step <= hint; step *= 2) {
+            if (goesBefore(arr[hint - step])) {
+                low = hint - step + 1;
+                break;
+            }
+            high = hint - step;
+        }
+    }
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (goesBefore(arr[mid])) { low = mid + 1; }
+        else { high = mid; }
+    }
+
+    return low;
+}
+
 void MathLib::sortArray(double arr[], size_t size, ISorter* sorter) {
     if (size <= 1 || !sorter) { return; }
     
     sorter->sort(arr, size);
 }
 
+// --- Selection Functions ---
+
+// Ranges longer than this first select k inside a smaller window around it to obtain a good pivot.
+const ptrdiff_t FLOYD_RIVEST_CUTOFF = 600;
+
+// Floyd-Rivest selection on arr[left, right]. Large ranges first select k inside a sample window,
+// which makes arr[k] an excellent pivot. The iteration budget bounds adversarial inputs: once it
+// runs out the remaining range is sorted, so the worst case stays O(n log n).
+static void floydRivestSelect(double arr[], ptrdiff_t left, ptrdiff_t right, ptrdiff_t k, size_t budget) {
+    while (right > left) {
+        if (budget-- == 0) {
+            std::sort(arr + left, arr + right + 1);
+            return;
+        }
+
+        if (right - left > FLOYD_RIVEST_CUTOFF) {
+            double n = static_cast<double>(right - left + 1);
+            double i = static_cast<double>(k - left + 1);
+            double z = std::log(n);
+            double s = 0.5 * std::exp(2.0 * z / 3.0);
+            double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2.0 ? -1.0 : 1.0);
+            ptrdiff_t newLeft = std::max(left, static_cast<ptrdiff_t>(std::floor(k - i * s / n + sd)));
+            ptrdiff_t newRight = std::min(right, static_cast<ptrdiff_t>(std::floor(k + (n - i) * s / n + sd)));
+            floydRivestSelect(arr, newLeft, newRight, k, budget);
+        }
+
+        // Partitions around t = arr[k], keeping copies of t at both ends as sentinels.
+        double t = arr[k];
+        ptrdiff_t i = left;
+        ptrdiff_t j = right;
+        std::swap(arr[left], arr[k]);
+        if (arr[right] > t) { std::swap(arr[right], arr[left]); }
+        while (i < j) {
+            std::swap(arr[i], arr[j]);
+            ++i;
+            --j;
+            while (arr[i] < t) { ++i; }
+            while (arr[j] > t) { --j; }
+        }
+
+        if (arr[left] == t) {
+            std::swap(arr[left], arr[j]);
+        }
+        else {
+            ++j;
+            std::swap(arr[j], arr[right]);
+        }
+
+        // arr[j] == t is now in its final position.
+        if (j <= k) { left = j + 1; }
+        if (k <= j) { right = j - 1; }
+    }
+}
+
+double MathLib::selectKth(double arr[], size_t size, size_t k) {
+    if (k >= size) { throw std::runtime_error("Selection rank is out of the array bounds."); }
+
+    size_t budget = 4 * static_cast<size_t>(std::bit_width(size)) + 8;
+    floydRivestSelect(arr, 0, static_cast<ptrdiff_t>(size) - 1, static_cast<ptrdiff_t>(k), budget);
+
+    return arr[k];
+}
+
+double MathLib::median(double arr[], size_t size) {
+    if (size == 0) { throw std::runtime_error("The array is empty."); }
+
+    double upper = MathLib::selectKth(arr, size, size / 2);
+    if (size % 2 != 0) { return upper; }
+
+    // After the selection the lower middle value is the largest element in front of the upper one.
+    double lower = MathLib::findMax(arr, size / 2);
+    return lower + (upper - lower) / 2.0;
+}
+
+double MathLib::percentile(double arr[], size_t size, double p) {
+    if (size == 0) { throw std::runtime_error("The array is empty."); }
+    if (!(p >= 0.0 && p <= 100.0)) { throw std::runtime_error("Percentile must be in the range [0, 100]."); }
+
+    double rank = p / 100.0 * static_cast<double>(size - 1);
+    size_t lowerRank = static_cast<size_t>(rank);
+    double fraction = rank - static_cast<double>(lowerRank);
+
+    double lower = MathLib::selectKth(arr, size, lowerRank);
+    if (fraction == 0.0 || lowerRank + 1 >= size) { return lower; }
+
+    // After the selection the next rank is the smallest element behind the selected one.
+    double upper = MathLib::findMin(arr + lowerRank + 1, size - lowerRank - 1);
+    return lower + (upper - lower) * fraction;
+}
+
+size_t MathLib::topK(const double arr[], size_t size, size_t k, double result[]) {
+    TopKTracker tracker(k);
+    for (size_t i = 0; i < size; ++i) {
+        tracker.add(arr[i]);
+    }
+
+    std::vector<double> values = tracker.values();
+    std::copy(values.begin(), values.end(), result);
+
+    return values.size();
+}
+
+TopKTracker::TopKTracker(size_t k) : capacity(k) {
+    heap.reserve(k);
+}
+
+void TopKTracker::add(double value) {
+    if (heap.size() < capacity) {
+        heap.push_back(value);
+        std::push_heap(heap.begin(), heap.end(), std::greater<double>());
+    }
+    else if (capacity > 0 && value > heap.front()) {
+        // Replaces the smallest kept value and restores the heap.
+        std::pop_heap(heap.begin(), heap.end(), std::greater<double>());
+        heap.back() = value;
+        std::push_heap(heap.begin(), heap.end(), std::greater<double>());
+    }
+}
+
+std::vector<double> TopKTracker::values() const {
+    std::vector<double> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), std::greater<double>());
+
+    return sorted;
+}
+
 // --- Utility Functions ---
 
 bool MathLib::isEven(int number) { return number % 2 == 0; }
@@ -4,7 +4,22 @@
 #define MATHLIB_H
 
 #include <cstddef> // Required for size_t
+#include <cstdint> // Required for uint64_t
 #include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Operation counters recorded by a sorter during its most recent sort() call.
+ *
+ * Counting is compiled into the library only when it is built with MATHLIB_SORT_STATS
+ * defined; otherwise `collected` stays false and the counters stay zero, so regular
+ * builds pay nothing for it.
+ */
+struct SortStats {
+    size_t comparisons = 0; // Element-to-element comparisons.
+    size_t moves = 0;       // Element writes into the array or a temporary buffer (a swap counts as 3).
+    bool collected = false; // True if the library was compiled with MATHLIB_SORT_STATS.
+};
 
 /**
  * @brief Abstract base class for all sorting algorithms.
@@ -16,6 +31,14 @@ class ISorter {
 public:
     virtual ~ISorter() = default;
     virtual void sort(double arr[], size_t size) = 0;
+
+    /**
+     * @brief Returns the operation counters of the last sort() call.
+     */
+    const SortStats& getStats() const { return stats; }
+
+protected:
+    SortStats stats;
 };
 
 // --- Concrete Sorting Algorithm Implementations ---
@@ -49,9 +72,41 @@ public:
  */
 class MergeSorter : public ISorter {
 public:
+    /**
+     * @brief Selects how the merge sort forms and merges its runs.
+     */
+    enum class Mode {
+        BottomUp, // Classic bottom-up merge sort: starts from width-1 runs and always does log n passes.
+        Natural   // Adaptive TimSort-style merge: reuses existing ascending/descending runs and gallops
+                  // through long one-sided stretches, so presorted input takes close to O(n) time.
+    };
+
+    explicit MergeSorter(Mode mode = Mode::BottomUp) : mode(mode) {}
+
     void sort(double arr[], size_t size) override;
 private:
+    // A run of already sorted elements arr[start, start + length) waiting to be merged.
+    struct Run {
+        size_t start;
+        size_t length;
+    };
+
+    Mode mode;
+    size_t minGallop = 0;       // Adaptive threshold for switching into galloping mode.
+    std::vector<Run> runs;       // Pending runs of the natural merge.
+    std::vector<double> buffer;  // Scratch space for the natural merge, reused across calls.
+
     void merge(double arr[], size_t left, size_t mid, size_t right);
+
+    void naturalSort(double arr[], size_t size);
+    size_t countRunAndMakeAscending(double arr[], size_t low, size_t high);
+    void binaryInsertionSort(double arr[], size_t low, size_t high, size_t start);
+    void mergeCollapse(double arr[]);
+    void mergeForceCollapse(double arr[]);
+    void mergeAt(double arr[], size_t index);
+    void mergeLow(double arr[], size_t base1, size_t length1, size_t base2, size_t length2);
+    void mergeHigh(double arr[], size_t base1, size_t length1, size_t base2, size_t length2);
+    size_t gallop(double key, const double arr[], size_t length, size_t hint, bool afterEqual);
 };
 
 // --------------------------------------------------
@@ -144,10 +199,29 @@ public:
      * @brief Calculates the greatest common divisor (GCD) of two numbers.
      * @param number1 The first integer.
      * @param number2 The second integer.
-     * @return The greatest common divisor of the two numbers.
+     * @return The greatest common divisor of the two numbers (non-negative; 0 if both are 0).
+     * @throws std::runtime_error if the result is 2^31, which happens only for gcd(INT_MIN, 0) and gcd(INT_MIN, INT_MIN).
      */
     static int gcd(int number1, int number2);
 
+    /**
+     * @brief Calculates the GCD of two 64-bit unsigned integers using the binary (Stein's) algorithm.
+     * Replaces division with shifts and subtractions driven by count-trailing-zeros.
+     * @param number1 The first integer.
+     * @param number2 The second integer.
+     * @return The greatest common divisor of the two numbers (0 if both are 0).
+     */
+    static uint64_t binaryGcd(uint64_t number1, uint64_t number2);
+
+    /**
+     * @brief Calculates the least common multiple (LCM) of two 64-bit unsigned integers.
+     * @param number1 The first integer.
+     * @param number2 The second integer.
+     * @return The least common multiple of the two numbers (0 if either is 0).
+     * @throws std::runtime_error if the result does not fit into 64 bits.
+     */
+    static uint64_t lcm(uint64_t number1, uint64_t number2);
+
     // --- Array Operations ---
 
     /**
@@ -185,6 +259,25 @@ public:
      */
     static double calculateAverage(const double arr[], size_t size);
 
+    /**
+     * @brief Calculates the element-wise GCD of two arrays: result[i] = gcd(first[i], second[i]).
+     * Large arrays are split into chunks processed in parallel across all hardware threads.
+     * @param first The first array of integers.
+     * @param second The second array of integers.
+     * @param result The output array (may alias first or second).
+     * @param size The number of elements in each array.
+     */
+    static void gcdArray(const uint64_t first[], const uint64_t second[], uint64_t result[], size_t size);
+
+    /**
+     * @brief Calculates the GCD of all elements in an array.
+     * Large arrays are reduced in parallel; the reduction stops early once the GCD reaches 1.
+     * @param arr The array of integers.
+     * @param size The number of elements in the array.
+     * @return The greatest common divisor of all elements (0 for an empty array).
+     */
+    static uint64_t gcdReduce(const uint64_t arr[], size_t size);
+
     /**
      * @brief Sorts an array using the specified algorithm.
      * @param arr The array of doubles to sort.
@@ -193,6 +286,51 @@ public:
      */
     static void sortArray(double arr[], size_t size, ISorter* sorter);
 
+    // --- Selection Functions ---
+    // These run in expected O(n) time without sorting the whole array. The functions that take
+    // a non-const array partially reorder it, like std::nth_element.
+
+    /**
+     * @brief Finds the k-th smallest element (0-based) using Floyd-Rivest introselect.
+     * After the call arr[k] holds that element, every element before it is not greater
+     * and every element after it is not smaller.
+     * @param arr The array of doubles; it is partially reordered.
+     * @param size The number of elements in the array.
+     * @param k The 0-based rank of the element to find.
+     * @return The k-th smallest element.
+     * @throws std::runtime_error if k is not less than size.
+     */
+    static double selectKth(double arr[], size_t size, size_t k);
+
+    /**
+     * @brief Calculates the median of an array (the mean of the two middle values for an even size).
+     * @param arr The array of doubles; it is partially reordered.
+     * @param size The number of elements in the array.
+     * @return The median of the array.
+     * @throws std::runtime_error if the array is empty.
+     */
+    static double median(double arr[], size_t size);
+
+    /**
+     * @brief Calculates a percentile with linear interpolation between the closest ranks.
+     * @param arr The array of doubles; it is partially reordered.
+     * @param size The number of elements in the array.
+     * @param p The percentile in the range [0, 100].
+     * @return The p-th percentile of the array.
+     * @throws std::runtime_error if the array is empty or p is outside [0, 100].
+     */
+    static double percentile(double arr[], size_t size, double p);
+
+    /**
+     * @brief Finds the k largest elements in a single pass using a bounded min-heap.
+     * @param arr The array of doubles; it is not modified.
+     * @param size The number of elements in the array.
+     * @param k The number of elements to find.
+     * @param result The output array for at least min(k, size) elements, filled in descending order.
+     * @return The number of elements written, min(k, size).
+     */
+    static size_t topK(const double arr[], size_t size, size_t k, double result[]);
+
     // --- Utility Functions ---
 
     /**
@@ -218,4 +356,39 @@ public:
     static long long fibonacci(int number);
 };
 
+/**
+ * @brief Streaming top-k tracker: keeps the k largest values seen so far in O(k) memory.
+ *
+ * Each add() costs O(1) when the value is not among the current top k and O(log k) otherwise,
+ * so it can follow an unbounded stream of values.
+ */
+class TopKTracker {
+public:
+    /**
+     * @brief Creates a tracker for the k largest values.
+     * @param k The number of values to keep.
+     */
+    explicit TopKTracker(size_t k);
+
+    /**
+     * @brief Offers a value to the tracker.
+     * @param value The value to consider.
+     */
+    void add(double value);
+
+    /**
+     * @brief Returns the tracked values in descending order.
+     */
+    std::vector<double> values() const;
+
+    /**
+     * @brief Returns the number of values currently tracked (at most k).
+     */
+    size_t size() const { return heap.size(); }
+
+private:
+    size_t capacity;
+    std::vector<double> heap; // Min-heap: heap.front() is the smallest of the kept values.
+};
+
 #endif // MATHLIB_H
\ No newline at end of file
@@ -0,0 +1,356 @@
+// SortBenchmark.cpp - A reproducible benchmark of every ISorter strategy in the MathLib static library.
+//
+// Usage: SortBenchmark [options]
+//   --sizes=10,100,...         Input sizes to run (default: powers of ten from 10 to 10^8).
+//   --max-size=N               Skips sizes above N (default: no limit).
+//   --quadratic-limit=N        Largest size run with the O(n^2) sorters (default: 100000).
+//   --sorters=bubble,merge,... Sorters to run (default: all).
+//   --distributions=random,... Input distributions to run (default: all).
+//   --repeats=N                Timed samples per case; the fastest one is reported (default: 3).
+//   --seed=N                   Seed for the input generator (default: 20240601).
+//   --format=table|csv|json    Output format (default: table).
+//   --output=PATH              Writes the report to PATH instead of stdout.
+//
+// Comparisons and moves are reported only if MathLib was compiled with -DMATHLIB_SORT_STATS.
+// Cache misses are read from Linux perf counters when the kernel allows it; otherwise they are reported as -1.
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include "MathLib.h"
+#include "GenericSorters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Elements sorted per timed sample; small inputs are replicated so that one sample is long enough to time.
+const size_t MIN_ELEMENTS_PER_SAMPLE = 65536;
+
+/**
+ * @brief Counts hardware cache misses of the calling thread through perf_event_open (Linux only).
+ */
+class CacheMissCounter {
+private:
+    int fd = -1;
+
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) { close(fd); }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool isAvailable() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops counting and returns the number of misses since start(), or -1 if counters are unavailable.
+    long long stop() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long count = 0;
+            if (read(fd, &count, sizeof(count)) == sizeof(count)) { return count; }
+        }
+#endif
+        return -1;
+    }
+};
+
+struct SorterEntry {
+    std::string name;
+    bool quadratic;
+    std::function<std::unique_ptr<ISorter>()> create;
+};
+
+struct BenchmarkResult {
+    std::string sorter;
+    std::string distribution;
+    size_t size = 0;
+    double nsPerElement = 0.0;
+    long long comparisons = -1;
+    long long moves = -1;
+    long long cacheMisses = -1;
+    bool sorted = false;
+};
+
+struct BenchmarkOptions {
+    std::vector<size_t> sizes = { 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+    size_t maxSize = SIZE_MAX;
+    size_t quadraticLimit = 100000;
+    std::vector<std::string> sorters;
+    std::vector<std::string> distributions;
+    size_t repeats = 3;
+    uint64_t seed = 20240601;
+    std::string format = "table";
+    std::string output;
+};
+
+const std::vector<SorterEntry>& allSorters() {
+    static const std::vector<SorterEntry> sorters = {
+        { "bubble", true, [] { return std::make_unique<BubbleSorter>(); } },
+        { "selection", true, [] { return std::make_unique<SelectionSorter>(); } },
+        { "insertion", true, [] { return std::make_unique<InsertionSorter>(); } },
+        { "merge", false, [] { return std::make_unique<MergeSorter>(); } },
+        { "natural-merge", false, [] { return std::make_unique<MergeSorter>(MergeSorter::Mode::Natural); } },
+        { "generic-insertion", true, [] { return std::make_unique<SorterAdapter<GenericInsertionSort>>(); } },
+        { "generic-merge", false, [] { return std::make_unique<SorterAdapter<GenericMergeSort>>(); } },
+        { "generic-quick", false, [] { return std::make_unique<SorterAdapter<GenericQuickSort>>(); } },
+    };
+    return sorters;
+}
+
+const std::vector<std::string>& allDistributions() {
+    static const std::vector<std::string> distributions = {
+        "random", "sorted", "reverse", "few-unique", "organ-pipe", "nearly-sorted", "appended"
+    };
+    return distributions;
+}
+
+// Generates the input array for the given distribution. The same seed always yields the same data.
+std::vector<double> generateInput(const std::string& distribution, size_t size, uint64_t seed) {
+    std::vector<double> data(size);
+    std::mt19937_64 generator(seed ^ size);
+
+    if (distribution == "random") {
+        std::uniform_real_distribution<double> values(-1e6, 1e6);
+        for (auto& value : data) { value = values(generator); }
+    }
+    else if (distribution == "sorted") {
+        for (size_t i = 0; i < size; ++i) { data[i] = static_cast<double>(i); }
+    }
+    else if (distribution == "reverse") {
+        for (size_t i = 0; i < size; ++i) { data[i] = static_cast<double>(size - i); }
+    }
+    else if (distribution == "few-unique") {
+        std::uniform_int_distribution<int> values(0, 15);
+        for (auto& value : data) { value = values(generator); }
+    }
+    else if (distribution == "organ-pipe") {
+        for (size_t i = 0; i < size; ++i) { data[i] = static_cast<double>(i < size / 2 ? i : size - i); }
+    }
+    else if (distribution == "nearly-sorted") {
+        // Sorted input with 1% of the elements swapped with random partners.
+        for (size_t i = 0; i < size; ++i) { data[i] = static_cast<double>(i); }
+        if (size > 1) {
+            std::uniform_int_distribution<size_t> positions(0, size - 1);
+            for (size_t swaps = size / 100; swaps > 0; --swaps) { std::swap(data[positions(generator)], data[positions(generator)]); }
+        }
+    }
+    else if (distribution == "appended") {
+        // A sorted time series with a 5% tail of new, unordered values appended.
+        size_t sortedPart = size - size / 20;
+        std::uniform_real_distribution<double> values(0.0, static_cast<double>(size));
+        for (size_t i = 0; i < size; ++i) { data[i] = i < sortedPart ? static_cast<double>(i) : values(generator); }
+    }
+    else {
+        throw std::runtime_error("Unknown distribution: " + distribution);
+    }
+
+    return data;
+}
+
+// Sorts `batch` copies of the input and reports the fastest of the repeated samples.
+BenchmarkResult runCase(const SorterEntry& entry, const std::string& distribution, size_t size,
+                        const BenchmarkOptions& options, CacheMissCounter& cacheMisses) {
+    BenchmarkResult result;
+    result.sorter = entry.name;
+    result.distribution = distribution;
+    result.size = size;
+
+    std::vector<double> input = generateInput(distribution, size, options.seed);
+    size_t batch = std::max<size_t>(1, MIN_ELEMENTS_PER_SAMPLE / std::max<size_t>(1, size));
+    std::vector<double> work(batch * size);
+    std::unique_ptr<ISorter> sorter = entry.create();
+
+    double bestNs = -1.0;
+    for (size_t repeat = 0; repeat < options.repeats; ++repeat) {
+        for (size_t copy = 0; copy < batch; ++copy) {
+            std::copy(input.begin(), input.end(), work.begin() + copy * size);
+        }
+
+        cacheMisses.start();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t copy = 0; copy < batch; ++copy) {
+            MathLib::sortArray(work.data() + copy * size, size, sorter.get());
+        }
+        auto end = std::chrono::steady_clock::now();
+        long long misses = cacheMisses.stop();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (bestNs < 0.0 || ns < bestNs) {
+            bestNs = ns;
+            result.cacheMisses = misses < 0 ? -1 : misses / static_cast<long long>(batch);
+        }
+    }
+
+    result.nsPerElement = bestNs / static_cast<double>(batch * std::max<size_t>(1, size));
+    result.sorted = std::is_sorted(work.begin(), work.begin() + size);
+
+    const SortStats& stats = sorter->getStats();
+    if (stats.collected) {
+        result.comparisons = static_cast<long long>(stats.comparisons);
+        result.moves = static_cast<long long>(stats.moves);
+    }
+
+    return result;
+}
+
+void writeTable(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << std::left << std::setw(20) << "sorter" << std::setw(15) << "input" << std::right
+        << std::setw(11) << "size" << std::setw(14) << "ns/element" << std::setw(16) << "comparisons"
+        << std::setw(16) << "moves" << std::setw(14) << "cache misses" << "  ok" << std::endl;
+
+    for (const auto& result : results) {
+        out << std::left << std::setw(20) << result.sorter << std::setw(15) << result.distribution << std::right
+            << std::setw(11) << result.size << std::setw(14) << std::fixed << std::setprecision(3) << result.nsPerElement
+            << std::setw(16) << result.comparisons << std::setw(16) << result.moves
+            << std::setw(14) << result.cacheMisses << "  " << (result.sorted ? "yes" : "NO") << std::endl;
+    }
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "sorter,distribution,size,ns_per_element,comparisons,moves,cache_misses,sorted" << std::endl;
+    for (const auto& result : results) {
+        out << result.sorter << ',' << result.distribution << ',' << result.size << ','
+            << std::setprecision(6) << result.nsPerElement << ',' << result.comparisons << ','
+            << result.moves << ',' << result.cacheMisses << ',' << (result.sorted ? "true" : "false") << std::endl;
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    out << "{\n  \"seed\": " << options.seed << ",\n  \"repeats\": " << options.repeats << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << "    { \"sorter\": \"" << result.sorter << "\", \"distribution\": \"" << result.distribution
+            << "\", \"size\": " << result.size << ", \"ns_per_element\": " << std::setprecision(6) << result.nsPerElement
+            << ", \"comparisons\": " << result.comparisons << ", \"moves\": " << result.moves
+            << ", \"cache_misses\": " << result.cacheMisses << ", \"sorted\": " << (result.sorted ? "true" : "false")
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}" << std::endl;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) { items.push_back(item); }
+    }
+    return items;
+}
+
+BenchmarkOptions parseOptions(int argc, char* argv[]) {
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        size_t separator = argument.find('=');
+        std::string key = argument.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : argument.substr(separator + 1);
+
+        if (key == "--sizes") {
+            options.sizes.clear();
+            for (const auto& item : splitList(value)) { options.sizes.push_back(static_cast<size_t>(std::stod(item))); }
+        }
+        else if (key == "--max-size") { options.maxSize = static_cast<size_t>(std::stod(value)); }
+        else if (key == "--quadratic-limit") { options.quadraticLimit = static_cast<size_t>(std::stod(value)); }
+        else if (key == "--sorters") { options.sorters = splitList(value); }
+        else if (key == "--distributions") { options.distributions = splitList(value); }
+        else if (key == "--repeats") { options.repeats = std::max<size_t>(1, std::stoull(value)); }
+        else if (key == "--seed") { options.seed = std::stoull(value); }
+        else if (key == "--format") { options.format = value; }
+        else if (key == "--output") { options.output = value; }
+        else { throw std::runtime_error("Unknown option: " + argument); }
+    }
+
+    if (options.distributions.empty()) { options.distributions = allDistributions(); }
+    if (options.format != "table" && options.format != "csv" && options.format != "json") {
+        throw std::runtime_error("Unknown format: " + options.format);
+    }
+
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+        CacheMissCounter cacheMisses;
+        std::vector<BenchmarkResult> results;
+
+        for (const auto& entry : allSorters()) {
+            if (!options.sorters.empty() &&
+                std::find(options.sorters.begin(), options.sorters.end(), entry.name) == options.sorters.end()) {
+                continue;
+            }
+
+            for (const auto& distribution : options.distributions) {
+                for (size_t size : options.sizes) {
+                    if (size > options.maxSize || (entry.quadratic && size > options.quadraticLimit)) { continue; }
+
+                    // Progress goes to stderr so that stdout holds only the report.
+                    std::cerr << "Running " << entry.name << " / " << distribution << " / " << size << "..." << std::endl;
+                    results.push_back(runCase(entry, distribution, size, options, cacheMisses));
+                }
+            }
+        }
+
+        std::ofstream file;
+        if (!options.output.empty()) {
+            file.open(options.output);
+            if (!file) { throw std::runtime_error("Cannot open output file " + options.output); }
+        }
+        std::ostream& out = options.output.empty() ? std::cout : file;
+
+        if (options.format == "json") { writeJson(out, results, options); }
+        else if (options.format == "csv") { writeCsv(out, results); }
+        else { writeTable(out, results); }
+
+        if (!cacheMisses.isAvailable()) {
+            std::cerr << "Note: hardware cache-miss counters are unavailable on this system." << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}